@@ -0,0 +1,477 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "routing_gen.h"
+#include "routing_timer.h"
+
+#ifndef LINKSTATE_BIN
+#define LINKSTATE_BIN "./linkstate"
+#endif
+#ifndef DISTVEC_BIN
+#define DISTVEC_BIN "./distvec"
+#endif
+
+// 벤치마크 - 합성 입력을 만들고 엔진마다 linkstate / distvec를 -t로 실행해 단계별 시간을 모음
+//   입력 읽기, 처음 수렴(SPF) = 0번 변경 사항, 변경 사항마다의 계산, 메시지 경로 출력, 테이블 출력
+//   처리량(변경 사항/초), 최대 RSS, 그리고 모든 엔진의 메시지 비용과 라우팅 테이블 거리가 첫 엔진과 같은지 확인
+//   (ch 엔진은 테이블을 출력하지 않으므로 메시지 비용만 비교, 계층 크기와 질의 시간은 표 아래에 따로 출력)
+// 생성한 입력보다 먼저 회귀 입력(bench_cases)마다 모든 엔진을 실행해 같은 방식으로 확인
+// routing_bench [생성기 옵션] [-e ls:dense,dv:fw,...] [-j threads] [-o dir]
+
+typedef struct BenchEngine_ {
+    const char* program;    // "ls" 또는 "dv"
+    const char* engine;
+} BenchEngine;
+
+static const BenchEngine bench_default_engines[] = {
+    {"ls", "dense"}, {"ls", "sparse"}, {"ls", "dynamic"}, {"ls", "fw"}, {"ls", "lazy"}, {"ls", "ch"},
+    {"dv", "sweep"}, {"dv", "worklist"}, {"dv", "sync"}, {"dv", "fw"},
+};
+
+// 회귀 입력 - 생성기가 만들지 않는 경우를 생성한 입력보다 먼저 모든 엔진으로 실행해 같은 방식으로 비교
+typedef struct BenchCase_ {
+    const char* name;
+    const char* topology;
+    const char* messages;
+    const char* changes;
+} BenchCase;
+
+static const BenchCase bench_cases[] = {
+    // 비용 0인 링크 - 거리가 같은 부모의 다음 홉이 아직 정해지지 않았는데 물려받던 경우
+    {"zero-cost", "7\n3 2 0\n2 0 0\n0 1 6\n", "3 1 zero-cost\n1 3 zero-cost\n", "4 1 -999\n"},
+    // 비용 0인 링크로 출발점에 되돌아오는 경로 - 출발점과 비용 0으로 이어진 노드의 행을 거쳐 다음 홉이 정해지는 경우
+    {"zero-cost-return",
+     "9\n0 4 7\n6 4 7\n5 3 0\n4 2 0\n4 2 2\n1 8 3\n7 1 3\n6 5 1\n8 7 7\n8 4 0\n8 0 0\n6 0 7\n5 3 3\n1 3 1\n"
+     "3 2 7\n1 8 3\n8 7 0\n4 8 0\n8 5 1\n8 4 7\n1 6 3\n",
+     "8 3 zero-cost-return\n0 6 zero-cost-return\n7 3 zero-cost-return\n",
+     "4 2 -999\n2 0 1\n4 7 -999\n1 2 -999\n"},
+};
+
+typedef struct BenchResult_ {
+    int ok;
+    double wall;
+    double parse;
+    double trace;
+    double output;
+    double* events;
+    int event_cnt;
+    long peak_rss_kb;
+    uint64_t* hashes;       // 변경 사항마다 라우팅 테이블 (라우터, 목적지, 거리) 해시
+    uint64_t* message_hashes; // 변경 사항마다 메시지 (송신자, 수신자, 비용) 해시
+    int hash_cnt;
+    int tables;             // 라우팅 테이블을 출력했는지
+    int ch;                 // ch 엔진의 "ch ..." 줄을 읽었는지 - 아래는 그 값
+    int ch_arcs;
+    int ch_shortcuts;
+    int ch_core;
+    int ch_contract_cnt;
+    double ch_contract;
+    long long ch_query_cnt;
+    double ch_query;
+    long long ch_search_cnt;
+    double ch_search;
+} BenchResult;
+
+typedef struct BenchOptions_ {
+    GenOptions gen;
+    BenchEngine* engines;
+    int engine_cnt;
+    const char* threads;
+    const char* dir;
+} BenchOptions;
+
+// "ls:dense,dv:fw" 형식의 엔진 목록
+int parse_engines(char* list, BenchOptions* opts) {
+    int cnt = 1;
+    for (const char* p = list; *p; p++) {
+        cnt += *p == ',';
+    }
+    opts->engines = (BenchEngine*)malloc(sizeof(BenchEngine) * cnt);
+    opts->engine_cnt = 0;
+    for (char* item = strtok(list, ","); item; item = strtok(NULL, ",")) {
+        char* colon = strchr(item, ':');
+        if (!colon) {
+            return 0;
+        }
+        *colon = '\0';
+        if (strcmp(item, "ls") != 0 && strcmp(item, "dv") != 0) {
+            return 0;
+        }
+        opts->engines[opts->engine_cnt].program = item;
+        opts->engines[opts->engine_cnt].engine = colon + 1;
+        opts->engine_cnt++;
+    }
+    return opts->engine_cnt > 0;
+}
+
+// 옵션을 읽음, 잘못된 옵션이면 0
+int parse_options(int argc, char* argv[], BenchOptions* opts) {
+    GenOptions* gen = &opts->gen;
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            return 0;
+        }
+        const char* option = argv[i];
+        char* value = argv[++i];
+        if (strcmp(option, "-k") == 0) {
+            gen->kind = gen_parse_kind(value);
+            if (gen->kind < 0) {
+                return 0;
+            }
+        } else if (strcmp(option, "-n") == 0) {
+            gen->node_cnt = atoi(value);
+        } else if (strcmp(option, "-d") == 0) {
+            gen->degree = atoi(value);
+        } else if (strcmp(option, "-w") == 0) {
+            if (sscanf(value, "%d:%d", &gen->weight_min, &gen->weight_max) != 2) {
+                return 0;
+            }
+        } else if (strcmp(option, "-c") == 0) {
+            gen->churn = atof(value);
+        } else if (strcmp(option, "-m") == 0) {
+            gen->message_cnt = atoi(value);
+        } else if (strcmp(option, "-s") == 0) {
+            gen->seed = strtoull(value, NULL, 10);
+        } else if (strcmp(option, "-e") == 0) {
+            if (!parse_engines(value, opts)) {
+                return 0;
+            }
+        } else if (strcmp(option, "-j") == 0) {
+            opts->threads = value;
+        } else if (strcmp(option, "-o") == 0) {
+            opts->dir = value;
+        } else {
+            return 0;
+        }
+    }
+    if (gen->weight_max > 998) {
+        gen->weight_max = 998;
+    }
+    return gen->node_cnt >= 0 && gen->degree >= 0 && gen->message_cnt >= 0 && gen->churn >= 0 &&
+           gen->weight_min >= 0 && gen->weight_min <= gen->weight_max;
+}
+
+static inline void hash_words(uint64_t* hash, const uint32_t* words, size_t cnt) {
+    const unsigned char* bytes = (const unsigned char*)words;
+    for (size_t b = 0; b < cnt * sizeof(uint32_t); b++) {
+        *hash = (*hash ^ bytes[b]) * 1099511628211ull;
+    }
+}
+
+// 출력 파일에서 변경 사항마다 라우팅 테이블 거리와 메시지 비용의 해시를 계산
+// 다음 홉과 메시지 경로는 같은 거리의 경로 중 무엇을 고르는지가 엔진마다 다를 수 있어 거리만 비교
+// 변경 사항마다 (라우터별 테이블 + 빈 줄) * 노드 수 다음에 메시지 줄과 빈 줄 - 테이블이 없으면 메시지 줄과 빈 줄만 있음
+void hash_output(const char* path, BenchResult* result) {
+    FILE* file = fopen(path, "r");
+    result->hashes = result->message_hashes = NULL;
+    result->hash_cnt = 0;
+    result->tables = 0;
+    if (!file) {
+        return;
+    }
+    int cap = 16;
+    result->hashes = (uint64_t*)malloc(sizeof(uint64_t) * cap);
+    result->message_hashes = (uint64_t*)malloc(sizeof(uint64_t) * cap);
+    char line[4096];
+    int router = 0, block_lines = 0, in_messages = 0;
+    uint64_t hash = 14695981039346656037ull, message_hash = hash;
+    while (fgets(line, sizeof(line), file)) {
+        if (line[0] == '\n') {
+            if (block_lines > 0 && !in_messages) {
+                // 라우터 하나의 테이블이 끝남
+                router++;
+                block_lines = 0;
+                continue;
+            }
+            // 변경 사항 하나가 끝남
+            if (result->hash_cnt == cap) {
+                cap *= 2;
+                result->hashes = (uint64_t*)realloc(result->hashes, sizeof(uint64_t) * cap);
+                result->message_hashes = (uint64_t*)realloc(result->message_hashes, sizeof(uint64_t) * cap);
+            }
+            result->hashes[result->hash_cnt] = hash;
+            result->message_hashes[result->hash_cnt++] = message_hash;
+            hash = message_hash = 14695981039346656037ull;
+            router = block_lines = in_messages = 0;
+            continue;
+        }
+        unsigned source, destination, next, distance;
+        char cost[16];
+        if (strncmp(line, "from ", 5) == 0 && sscanf(line, "from %u to %u cost %15s", &source, &destination, cost) == 3) {
+            uint32_t words[3] = {source, destination, strcmp(cost, "infinite") == 0 ? UINT32_MAX : (uint32_t)strtoul(cost, NULL, 10)};
+            hash_words(&message_hash, words, 3);
+            in_messages = 1;
+        } else if (!in_messages && sscanf(line, "%u %u %u", &destination, &next, &distance) == 3) {
+            uint32_t words[3] = {(uint32_t)router, destination, distance};
+            hash_words(&hash, words, 3);
+            block_lines++;
+            result->tables = 1;
+        }
+    }
+    fclose(file);
+}
+
+// 엔진 하나 실행 - 결과 파일은 dir에 남음
+void run_engine(const BenchOptions* opts, const BenchEngine* engine, const char* ls_bin, const char* dv_bin, BenchResult* result) {
+    int is_ls = strcmp(engine->program, "ls") == 0;
+    const char* args[16];
+    int argn = 0;
+    args[argn++] = is_ls ? ls_bin : dv_bin;
+    args[argn++] = "-e";
+    args[argn++] = engine->engine;
+    if (is_ls && strcmp(engine->engine, "lazy") == 0) {
+        args[argn++] = "-p";     // lazy 엔진은 -p가 있어야 라우팅 테이블을 출력 (ch는 모든 쌍을 질의하게 되므로 메시지만 비교)
+    }
+    if (opts->threads) {
+        args[argn++] = "-j";
+        args[argn++] = opts->threads;
+    }
+    args[argn++] = "-t";
+    args[argn++] = "topology.txt";
+    args[argn++] = "messages.txt";
+    args[argn++] = "changes.txt";
+    args[argn] = NULL;
+
+    memset(result, 0, sizeof(*result));
+    int pipefd[2];
+    if (pipe(pipefd) != 0) {
+        return;
+    }
+    double start = timer_now();
+    pid_t pid = fork();
+    if (pid == 0) {
+        int devnull = open("/dev/null", O_WRONLY);
+        dup2(devnull, STDOUT_FILENO);
+        dup2(pipefd[1], STDERR_FILENO);
+        close(pipefd[0]);
+        if (chdir(opts->dir) != 0) {
+            _exit(127);
+        }
+        execv(args[0], (char* const*)args);
+        _exit(127);
+    }
+    close(pipefd[1]);
+
+    // stderr의 "timing ..." 줄과 ch 엔진의 "ch ..." 줄 읽기
+    FILE* timing = fdopen(pipefd[0], "r");
+    char line[256];
+    int cap = 16;
+    result->events = (double*)malloc(sizeof(double) * cap);
+    while (fgets(line, sizeof(line), timing)) {
+        int index;
+        double seconds;
+        if (sscanf(line, "timing event %d %lf", &index, &seconds) == 2) {
+            if (result->event_cnt == cap) {
+                cap *= 2;
+                result->events = (double*)realloc(result->events, sizeof(double) * cap);
+            }
+            result->events[result->event_cnt++] = seconds;
+        } else if (sscanf(line, "timing parse %lf", &seconds) == 1) {
+            result->parse = seconds;
+        } else if (sscanf(line, "timing trace %lf", &seconds) == 1) {
+            result->trace = seconds;
+        } else if (sscanf(line, "timing output %lf", &seconds) == 1) {
+            result->output = seconds;
+        } else if (sscanf(line, "ch arcs %d shortcuts %d core %d", &result->ch_arcs, &result->ch_shortcuts, &result->ch_core) == 3) {
+            result->ch = 1;
+        } else if (sscanf(line, "ch contract %d %lf", &result->ch_contract_cnt, &result->ch_contract) == 2) {
+        } else if (sscanf(line, "ch query %lld %lf", &result->ch_query_cnt, &result->ch_query) == 2) {
+        } else if (sscanf(line, "ch search %lld %lf", &result->ch_search_cnt, &result->ch_search) == 2) {
+        }
+    }
+    fclose(timing);
+
+    int status;
+    struct rusage usage;
+    if (pid < 0 || wait4(pid, &status, 0, &usage) < 0) {
+        return;
+    }
+    result->wall = timer_now() - start;
+    result->peak_rss_kb = usage.ru_maxrss;
+    result->ok = WIFEXITED(status) && WEXITSTATUS(status) == 0 && result->event_cnt > 0;
+    if (result->ok) {
+        char path[PATH_MAX];
+        snprintf(path, sizeof(path), "%s/%s", opts->dir, is_ls ? "output_ls.txt" : "output_dv.txt");
+        hash_output(path, result);
+    }
+}
+
+// 기준 엔진과 해시 비교 결과
+void describe_check(const BenchResult* base, const BenchResult* result, char* text, size_t size) {
+    if (!result->ok) {
+        snprintf(text, size, "failed");
+    } else if (base == result) {
+        snprintf(text, size, "base");
+    } else if (!base) {
+        snprintf(text, size, "-");
+    } else if (base->hash_cnt != result->hash_cnt) {
+        snprintf(text, size, "events %d != %d", result->hash_cnt, base->hash_cnt);
+    } else {
+        snprintf(text, size, "ok");
+        int tables = base->tables && result->tables;
+        for (int e = 0; e < base->hash_cnt; e++) {
+            if (base->message_hashes[e] != result->message_hashes[e] || (tables && base->hashes[e] != result->hashes[e])) {
+                snprintf(text, size, "DIFF at event %d", e);
+                break;
+            }
+        }
+    }
+}
+
+// dir에 입력 파일 하나 기록
+int write_input(const char* dir, const char* name, const char* text) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        printf("Error: cannot write %s\n", path);
+        return 0;
+    }
+    fputs(text, file);
+    fclose(file);
+    return 1;
+}
+
+// 회귀 입력마다 모든 엔진을 실행해 첫 엔진과 비교 - 어긋난 엔진이 있으면 0
+int run_cases(const BenchOptions* opts, const BenchEngine* engines, int engine_cnt, const char* ls_bin, const char* dv_bin) {
+    int passed = 1;
+    BenchResult* results = (BenchResult*)calloc(engine_cnt, sizeof(BenchResult));
+    for (size_t c = 0; c < sizeof(bench_cases) / sizeof(bench_cases[0]); c++) {
+        const BenchCase* test = &bench_cases[c];
+        if (!write_input(opts->dir, "topology.txt", test->topology) ||
+            !write_input(opts->dir, "messages.txt", test->messages) ||
+            !write_input(opts->dir, "changes.txt", test->changes)) {
+            passed = 0;
+            break;
+        }
+        printf("case %-18s", test->name);
+        BenchResult* base = NULL;
+        int failed = 0;
+        for (int e = 0; e < engine_cnt; e++) {
+            run_engine(opts, &engines[e], ls_bin, dv_bin, &results[e]);
+            if (!base && results[e].ok) {
+                base = &results[e];
+            }
+            char check[64];
+            describe_check(base, &results[e], check, sizeof(check));
+            if (strcmp(check, "ok") != 0 && strcmp(check, "base") != 0) {
+                printf(" %s %s: %s;", engines[e].program, engines[e].engine, check);
+                failed = 1;
+            }
+        }
+        printf("%s\n", failed ? "" : " ok");
+        fflush(stdout);
+        passed &= !failed;
+        for (int e = 0; e < engine_cnt; e++) {
+            free(results[e].events);
+            free(results[e].hashes);
+            free(results[e].message_hashes);
+        }
+        memset(results, 0, sizeof(BenchResult) * engine_cnt);
+    }
+    free(results);
+    return passed;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions opts;
+    gen_default_options(&opts.gen);
+    opts.gen.node_cnt = 200;
+    opts.engines = NULL;
+    opts.engine_cnt = 0;
+    opts.threads = NULL;
+    opts.dir = NULL;
+    if (!parse_options(argc, argv, &opts)) {
+        printf("usage: routing_bench [-k random|grid|fattree|scalefree] [-n N] [-d degree] [-w min:max] [-c churn] [-m messages] [-s seed] [-e ls:dense,dv:fw,...] [-j threads] [-o dir]\n");
+        return 1;
+    }
+    const BenchEngine* engines = opts.engines ? opts.engines : bench_default_engines;
+    int engine_cnt = opts.engines ? opts.engine_cnt : (int)(sizeof(bench_default_engines) / sizeof(bench_default_engines[0]));
+
+    // 자식은 작업 디렉터리로 이동하므로 실행 파일은 절대 경로로
+    char ls_bin[PATH_MAX], dv_bin[PATH_MAX];
+    if (!realpath(LINKSTATE_BIN, ls_bin) || !realpath(DISTVEC_BIN, dv_bin)) {
+        printf("Error: cannot find %s or %s\n", LINKSTATE_BIN, DISTVEC_BIN);
+        return 1;
+    }
+    char temp_dir[] = "/tmp/routing_bench.XXXXXX";
+    if (!opts.dir) {
+        if (!mkdtemp(temp_dir)) {
+            printf("Error: cannot create work directory\n");
+            return 1;
+        }
+        opts.dir = temp_dir;
+    }
+
+    int mismatch = !run_cases(&opts, engines, engine_cnt, ls_bin, dv_bin);
+
+    GenNetwork net;
+    gen_build(&net, &opts.gen);
+    opts.gen.node_cnt = net.node_cnt;
+    int change_cnt = gen_write(&net, &opts.gen, opts.dir);
+    if (change_cnt < 0) {
+        gen_free(&net);
+        return 1;
+    }
+    printf("input: nodes %d links %d changes %d messages %d (%s)\n", net.node_cnt, net.edge_cnt, change_cnt, opts.gen.message_cnt, opts.dir);
+    gen_free(&net);
+
+    printf("%-12s %9s %9s %9s %7s %11s %11s %11s %9s %9s %9s  %s\n",
+           "engine", "wall(s)", "parse(s)", "init(s)", "events", "avg(ms)", "max(ms)", "changes/s",
+           "trace(s)", "output(s)", "rss(MB)", "check");
+    BenchResult* results = (BenchResult*)calloc(engine_cnt, sizeof(BenchResult));
+    BenchResult* base = NULL;
+    for (int e = 0; e < engine_cnt; e++) {
+        BenchResult* result = &results[e];
+        run_engine(&opts, &engines[e], ls_bin, dv_bin, result);
+        if (!base && result->ok) {
+            base = result;
+        }
+
+        // 0번은 처음 수렴(SPF), 나머지가 변경 사항
+        double change_sum = 0, change_max = 0;
+        for (int i = 1; i < result->event_cnt; i++) {
+            change_sum += result->events[i];
+            change_max = result->events[i] > change_max ? result->events[i] : change_max;
+        }
+        int changes = result->event_cnt > 0 ? result->event_cnt - 1 : 0;
+        char name[64], check[64];
+        snprintf(name, sizeof(name), "%s %s", engines[e].program, engines[e].engine);
+        describe_check(base, result, check, sizeof(check));
+        mismatch |= strcmp(check, "ok") != 0 && strcmp(check, "base") != 0;
+        printf("%-12s %9.3f %9.3f %9.3f %7d %11.3f %11.3f %11.0f %9.3f %9.3f %9.1f  %s\n",
+               name, result->wall, result->parse, result->event_cnt > 0 ? result->events[0] : 0.0, changes,
+               changes > 0 ? change_sum / changes * 1e3 : 0.0, change_max * 1e3,
+               change_sum > 0 ? changes / change_sum : 0.0,
+               result->trace, result->output, result->peak_rss_kb / 1024.0, check);
+        fflush(stdout);
+    }
+
+    // ch 엔진의 계층 크기 (arc = 링크 + shortcut, core는 축약하지 않고 남긴 노드)와 축약 / 질의 시간
+    for (int e = 0; e < engine_cnt; e++) {
+        const BenchResult* result = &results[e];
+        if (!result->ch) {
+            continue;
+        }
+        printf("%s %s: arcs %d (shortcuts %d) core %d, contractions %d %.3fs, hierarchy queries %lld %.1fus avg, graph searches %lld %.1fus avg\n",
+               engines[e].program, engines[e].engine, result->ch_arcs, result->ch_shortcuts, result->ch_core,
+               result->ch_contract_cnt, result->ch_contract,
+               result->ch_query_cnt, result->ch_query_cnt > 0 ? result->ch_query / result->ch_query_cnt * 1e6 : 0.0,
+               result->ch_search_cnt, result->ch_search_cnt > 0 ? result->ch_search / result->ch_search_cnt * 1e6 : 0.0);
+    }
+
+    for (int e = 0; e < engine_cnt; e++) {
+        free(results[e].events);
+        free(results[e].hashes);
+        free(results[e].message_hashes);
+    }
+    free(results);
+    free(opts.engines);
+    return mismatch ? 2 : 0;
+}
@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "routing_gen.h"
+
+// 합성 입력 생성기
+// routing_gen [-k random|grid|fattree|scalefree] [-n N] [-d degree] [-w min:max] [-c churn] [-m messages] [-s seed] [-o dir]
+
+// 옵션을 읽음, 잘못된 옵션이면 0
+int parse_options(int argc, char* argv[], GenOptions* opts, const char** dir) {
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            return 0;
+        }
+        const char* value = argv[++i];
+        if (strcmp(argv[i - 1], "-k") == 0) {
+            opts->kind = gen_parse_kind(value);
+            if (opts->kind < 0) {
+                return 0;
+            }
+        } else if (strcmp(argv[i - 1], "-n") == 0) {
+            opts->node_cnt = atoi(value);
+        } else if (strcmp(argv[i - 1], "-d") == 0) {
+            opts->degree = atoi(value);
+        } else if (strcmp(argv[i - 1], "-w") == 0) {
+            if (sscanf(value, "%d:%d", &opts->weight_min, &opts->weight_max) != 2) {
+                return 0;
+            }
+        } else if (strcmp(argv[i - 1], "-c") == 0) {
+            opts->churn = atof(value);
+        } else if (strcmp(argv[i - 1], "-m") == 0) {
+            opts->message_cnt = atoi(value);
+        } else if (strcmp(argv[i - 1], "-s") == 0) {
+            opts->seed = strtoull(value, NULL, 10);
+        } else if (strcmp(argv[i - 1], "-o") == 0) {
+            *dir = value;
+        } else {
+            return 0;
+        }
+    }
+    // 비용 999 이상은 기존 형식에서 링크 없음이므로 998까지만
+    if (opts->weight_max > 998) {
+        opts->weight_max = 998;
+    }
+    return opts->node_cnt >= 0 && opts->degree >= 0 && opts->message_cnt >= 0 && opts->churn >= 0 &&
+           opts->weight_min >= 0 && opts->weight_min <= opts->weight_max;
+}
+
+int main(int argc, char* argv[]) {
+    GenOptions opts;
+    const char* dir = ".";
+    gen_default_options(&opts);
+    if (!parse_options(argc, argv, &opts, &dir)) {
+        printf("usage: routing_gen [-k random|grid|fattree|scalefree] [-n N] [-d degree] [-w min:max] [-c churn] [-m messages] [-s seed] [-o dir]\n");
+        return 1;
+    }
+
+    GenNetwork net;
+    gen_build(&net, &opts);
+    int change_cnt = gen_write(&net, &opts, dir);
+    if (change_cnt < 0) {
+        gen_free(&net);
+        return 1;
+    }
+    printf("nodes %d links %d changes %d messages %d\n", net.node_cnt, net.edge_cnt, change_cnt, opts.message_cnt);
+    gen_free(&net);
+    return 0;
+}
@@ -0,0 +1,356 @@
+#ifndef ROUTING_GEN_H
+#define ROUTING_GEN_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// 합성 토폴로지 생성기 - 기존 형식 그대로 topology.txt, messages.txt, changes.txt를 만듦
+//   random    : 무작위 신장 트리 + 평균 차수가 degree가 될 때까지 무작위 링크
+//   grid      : 한 변이 ceil(sqrt(N))인 격자 (상하좌우)
+//   fattree   : k-ary fat-tree (코어, 집선, 에지 스위치, 호스트 순 번호) - N개가 되는 가장 작은 짝수 k, 넘치는 호스트는 버림
+//   scalefree : Barabási-Albert 선호적 연결 (새 노드마다 degree / 2개 링크)
+// 변경 사항은 링크 수 * churn개 - 링크 끊기(-999), 비용 변경, 끊긴 링크 다시 연결을 섞음
+// 같은 시드면 같은 파일이 나옴
+
+enum GenKind {
+    GEN_RANDOM,
+    GEN_GRID,
+    GEN_FATTREE,
+    GEN_SCALEFREE
+};
+
+typedef struct GenOptions_ {
+    int kind;
+    int node_cnt;
+    int degree;         // 평균 차수 (random, scalefree)
+    int weight_min;     // 링크 비용 범위 [weight_min, weight_max]
+    int weight_max;
+    double churn;       // 변경 사항 수 = 링크 수 * churn
+    int message_cnt;
+    uint64_t seed;
+} GenOptions;
+
+typedef struct GenEdge_ {
+    int a;
+    int b;
+    int cost;
+    int up;             // 변경 사항을 만들 때 현재 연결 상태
+} GenEdge;
+
+typedef struct GenNetwork_ {
+    int node_cnt;
+    GenEdge* edges;
+    int edge_cnt;
+    int edge_cap;
+    uint64_t* keys;     // 중복 링크 확인용 해시 집합 (0은 빈 칸)
+    int key_cap;
+    uint64_t rng;
+} GenNetwork;
+
+static inline void gen_default_options(GenOptions* opts) {
+    opts->kind = GEN_RANDOM;
+    opts->node_cnt = 100;
+    opts->degree = 4;
+    opts->weight_min = 1;
+    opts->weight_max = 20;
+    opts->churn = 0.1;
+    opts->message_cnt = 10;
+    opts->seed = 1;
+}
+
+static inline int gen_parse_kind(const char* name) {
+    if (strcmp(name, "random") == 0) {
+        return GEN_RANDOM;
+    } else if (strcmp(name, "grid") == 0) {
+        return GEN_GRID;
+    } else if (strcmp(name, "fattree") == 0) {
+        return GEN_FATTREE;
+    } else if (strcmp(name, "scalefree") == 0) {
+        return GEN_SCALEFREE;
+    }
+    return -1;
+}
+
+// splitmix64
+static inline uint64_t gen_next(GenNetwork* net) {
+    uint64_t z = (net->rng += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// [0, bound)
+static inline int gen_uniform(GenNetwork* net, int bound) {
+    return (int)(gen_next(net) % (uint64_t)bound);
+}
+
+static inline int gen_weight(GenNetwork* net, const GenOptions* opts) {
+    return opts->weight_min + gen_uniform(net, opts->weight_max - opts->weight_min + 1);
+}
+
+static inline uint64_t gen_key(int a, int b) {
+    if (a > b) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+    return ((uint64_t)(uint32_t)a << 32 | (uint32_t)b) + 1;
+}
+
+static inline size_t gen_slot(const GenNetwork* net, uint64_t key) {
+    return (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & (size_t)(net->key_cap - 1);
+}
+
+static inline int gen_has_edge(const GenNetwork* net, int a, int b) {
+    uint64_t key = gen_key(a, b);
+    for (size_t s = gen_slot(net, key); net->keys[s] != 0; s = (s + 1) & (size_t)(net->key_cap - 1)) {
+        if (net->keys[s] == key) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static inline void gen_insert_key(GenNetwork* net, uint64_t key) {
+    size_t s = gen_slot(net, key);
+    while (net->keys[s] != 0) {
+        s = (s + 1) & (size_t)(net->key_cap - 1);
+    }
+    net->keys[s] = key;
+}
+
+// 자기 자신 링크와 이미 있는 링크는 넣지 않음. 넣었으면 1
+static inline int gen_add_edge(GenNetwork* net, const GenOptions* opts, int a, int b) {
+    if (a == b || gen_has_edge(net, a, b)) {
+        return 0;
+    }
+    if ((net->edge_cnt + 1) * 2 > net->key_cap) {
+        uint64_t* old = net->keys;
+        int old_cap = net->key_cap;
+        net->key_cap *= 2;
+        net->keys = (uint64_t*)calloc(net->key_cap, sizeof(uint64_t));
+        for (int s = 0; s < old_cap; s++) {
+            if (old[s] != 0) {
+                gen_insert_key(net, old[s]);
+            }
+        }
+        free(old);
+    }
+    gen_insert_key(net, gen_key(a, b));
+    if (net->edge_cnt == net->edge_cap) {
+        net->edge_cap *= 2;
+        net->edges = (GenEdge*)realloc(net->edges, sizeof(GenEdge) * net->edge_cap);
+    }
+    GenEdge* edge = &net->edges[net->edge_cnt++];
+    edge->a = a;
+    edge->b = b;
+    edge->cost = gen_weight(net, opts);
+    edge->up = 1;
+    return 1;
+}
+
+static inline void gen_random(GenNetwork* net, const GenOptions* opts) {
+    int n = net->node_cnt;
+    for (int i = 1; i < n; i++) {
+        gen_add_edge(net, opts, i, gen_uniform(net, i));
+    }
+    long long target = (long long)n * opts->degree / 2;
+    long long max_edges = (long long)n * (n - 1) / 2;
+    if (target > max_edges) {
+        target = max_edges;
+    }
+    while (net->edge_cnt < target) {
+        gen_add_edge(net, opts, gen_uniform(net, n), gen_uniform(net, n));
+    }
+}
+
+static inline void gen_grid(GenNetwork* net, const GenOptions* opts) {
+    int n = net->node_cnt;
+    int cols = 1;
+    while (cols * cols < n) {
+        cols++;
+    }
+    for (int i = 0; i < n; i++) {
+        if ((i + 1) % cols != 0 && i + 1 < n) {
+            gen_add_edge(net, opts, i, i + 1);
+        }
+        if (i + cols < n) {
+            gen_add_edge(net, opts, i, i + cols);
+        }
+    }
+}
+
+// 노드 번호: 코어 (k/2)^2개, 팟마다 집선 k/2개, 팟마다 에지 k/2개, 에지마다 호스트 k/2개
+static inline void gen_fattree(GenNetwork* net, const GenOptions* opts) {
+    int n = net->node_cnt;
+    int k = 2;
+    while ((long long)(k / 2) * (k / 2) + (long long)k * k + (long long)k * k * k / 4 < n) {
+        k += 2;
+    }
+    int half = k / 2;
+    int core = half * half;
+    int agg = core;                 // 첫 집선 스위치 번호
+    int edge = agg + k * half;      // 첫 에지 스위치 번호
+    int host = edge + k * half;     // 첫 호스트 번호
+    for (int pod = 0; pod < k; pod++) {
+        for (int a = 0; a < half; a++) {
+            int agg_id = agg + pod * half + a;
+            for (int c = 0; c < half; c++) {
+                int core_id = a * half + c;
+                if (agg_id < n) {
+                    gen_add_edge(net, opts, core_id, agg_id);
+                }
+            }
+            for (int e = 0; e < half; e++) {
+                int edge_id = edge + pod * half + e;
+                if (agg_id < n && edge_id < n) {
+                    gen_add_edge(net, opts, agg_id, edge_id);
+                }
+            }
+        }
+        for (int e = 0; e < half; e++) {
+            int edge_id = edge + pod * half + e;
+            for (int h = 0; h < half; h++) {
+                int host_id = host + (pod * half + e) * half + h;
+                if (host_id < n) {
+                    gen_add_edge(net, opts, edge_id, host_id);
+                }
+            }
+        }
+    }
+}
+
+// 처음 m + 1개는 완전 그래프, 이후 노드는 차수에 비례한 확률로 m개 노드에 연결
+static inline void gen_scalefree(GenNetwork* net, const GenOptions* opts) {
+    int n = net->node_cnt;
+    int m = opts->degree / 2 > 0 ? opts->degree / 2 : 1;
+    int seed_cnt = m + 1 < n ? m + 1 : n;
+    for (int i = 0; i < seed_cnt; i++) {
+        for (int j = i + 1; j < seed_cnt; j++) {
+            gen_add_edge(net, opts, i, j);
+        }
+    }
+    for (int i = seed_cnt; i < n; i++) {
+        int added = 0;
+        int tries = 0;
+        while (added < m && tries < m * 32) {
+            // 지금까지의 링크에서 끝점 하나를 고르면 차수에 비례해 고르는 것과 같음
+            const GenEdge* pick = &net->edges[gen_uniform(net, net->edge_cnt)];
+            int target = gen_uniform(net, 2) ? pick->a : pick->b;
+            if (target < i && gen_add_edge(net, opts, i, target)) {
+                added++;
+            }
+            tries++;
+        }
+        if (added == 0) {
+            gen_add_edge(net, opts, i, gen_uniform(net, i));
+        }
+    }
+}
+
+// 토폴로지 만들기
+static inline void gen_build(GenNetwork* net, const GenOptions* opts) {
+    net->node_cnt = opts->node_cnt;
+    net->edge_cap = 64;
+    net->edge_cnt = 0;
+    net->edges = (GenEdge*)malloc(sizeof(GenEdge) * net->edge_cap);
+    net->key_cap = 128;
+    net->keys = (uint64_t*)calloc(net->key_cap, sizeof(uint64_t));
+    net->rng = opts->seed;
+    if (net->node_cnt < 2) {
+        return;
+    }
+    switch (opts->kind) {
+    case GEN_GRID:
+        gen_grid(net, opts);
+        break;
+    case GEN_FATTREE:
+        gen_fattree(net, opts);
+        break;
+    case GEN_SCALEFREE:
+        gen_scalefree(net, opts);
+        break;
+    default:
+        gen_random(net, opts);
+        break;
+    }
+}
+
+static inline void gen_free(GenNetwork* net) {
+    free(net->edges);
+    free(net->keys);
+    net->edges = NULL;
+    net->keys = NULL;
+}
+
+static inline FILE* gen_open(const char* dir, const char* name) {
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        printf("Error: cannot write %s\n", path);
+    }
+    return file;
+}
+
+// dir에 topology.txt, messages.txt, changes.txt 기록. 변경 사항 수를 돌려주고 실패하면 -1
+static inline int gen_write(GenNetwork* net, const GenOptions* opts, const char* dir) {
+    FILE* topologyfile = gen_open(dir, "topology.txt");
+    FILE* messagesfile = gen_open(dir, "messages.txt");
+    FILE* changesfile = gen_open(dir, "changes.txt");
+    if (!topologyfile || !messagesfile || !changesfile) {
+        if (topologyfile) fclose(topologyfile);
+        if (messagesfile) fclose(messagesfile);
+        if (changesfile) fclose(changesfile);
+        return -1;
+    }
+
+    fprintf(topologyfile, "%d\n", net->node_cnt);
+    for (int e = 0; e < net->edge_cnt; e++) {
+        fprintf(topologyfile, "%d %d %d\n", net->edges[e].a, net->edges[e].b, net->edges[e].cost);
+    }
+
+    for (int m = 0; m < opts->message_cnt && net->node_cnt >= 2; m++) {
+        int sender = gen_uniform(net, net->node_cnt);
+        int receiver = gen_uniform(net, net->node_cnt - 1);
+        receiver += receiver >= sender;
+        fprintf(messagesfile, "%d %d message %d from %d to %d\n", sender, receiver, m, sender, receiver);
+    }
+
+    // 변경 사항: 끊긴 링크가 있으면 1/3 확률로 다시 연결, 나머지는 반씩 끊기와 비용 변경
+    int change_cnt = net->edge_cnt > 0 ? (int)(net->edge_cnt * opts->churn + 0.5) : 0;
+    int down_cnt = 0;
+    for (int c = 0; c < change_cnt; c++) {
+        GenEdge* edge = &net->edges[gen_uniform(net, net->edge_cnt)];
+        int roll = gen_uniform(net, 3);
+        if (down_cnt > 0 && roll == 0) {
+            while (edge->up) {
+                edge = &net->edges[gen_uniform(net, net->edge_cnt)];
+            }
+            edge->up = 1;
+            edge->cost = gen_weight(net, opts);
+            down_cnt--;
+        } else if (edge->up && roll == 1) {
+            edge->up = 0;
+            down_cnt++;
+            fprintf(changesfile, "%d %d -999\n", edge->a, edge->b);
+            continue;
+        } else {
+            edge->cost = gen_weight(net, opts);
+            if (!edge->up) {
+                edge->up = 1;
+                down_cnt--;
+            }
+        }
+        fprintf(changesfile, "%d %d %d\n", edge->a, edge->b, edge->cost);
+    }
+
+    fclose(topologyfile);
+    fclose(messagesfile);
+    fclose(changesfile);
+    return change_cnt;
+}
+
+#endif
@@ -1,182 +1,1478 @@
 #include <stdio.h>
 #include <stdlib.h>
-#define MAXLINE 1000
-
-//  Struct 노드(Node) - 목적지, 거리, 다음 노드
-typedef struct Node_ {
-    char destination;
-    int distance;
-    char next;
-} Node;
-
-void process_network_changes(FILE* topology, FILE* changesfile, FILE* outputfile, FILE* messagesfile);
-void initialize_network_from_topology(FILE* topology, Node*** network, int node_cnt);
-int apply_changes(FILE* changesfile, Node*** network, int node_cnt, int change);
-void free_network_memory(Node** network, int node_cnt);
-void initnetwork(FILE* topology, Node*** network, int node_cnt);
-int change_cnt_network(Node*** network, int node_cnt);
-void sender_to_reciever(FILE* outputfile, FILE* messagesfile, Node** network);
-void set_infinite_distance(Node*** network, int node_1, int node_2);
-int change_network(FILE* changesfile, Node*** network, int node_cnt, int change);
-void net_print(FILE* outputfile, Node** network, int node_cnt);
+#include <string.h>
+#include "routing_input.h"
+#include "routing_graph.h"
+#include "routing_table.h"
+#include "routing_simd.h"
+#include "routing_stream.h"
+#include "routing_pool.h"
+#include "routing_fw.h"
+#include "routing_output.h"
+#include "routing_message.h"
+#include "routing_timer.h"
+#include "routing_stats.h"
+#include "routing_daemon.h"
+#include "routing_snapshot.h"
+#include "routing_batch.h"
+#include "routing_arena.h"
+
+#define ENGINE_SWEEP 0      // 모든 라우터를 반복해서 훑는 방식 (기존 방식)
+#define ENGINE_WORKLIST 1   // 벡터가 바뀐 라우터의 이웃만 다시 계산 (triggered update)
+#define ENGINE_SYNC 2       // 이전 라운드의 벡터만 읽는 동기식 라운드 (이중 버퍼, 멀티스레드)
+#define ENGINE_FW 3         // 타일 단위 Floyd-Warshall (밀집 토폴로지용 all-pairs)
+#define ENGINE_SIM 4        // 링크 지연과 업데이트 타이머를 둔 이벤트 기반 프로토콜 시뮬레이션
+
+static const char* const engine_names[] = {"sweep", "worklist", "sync", "fw", "sim"};
+
+#define HORIZON_NONE 0
+#define HORIZON_SPLIT 1     // 다음 홉인 이웃에게는 그 경로를 알리지 않음
+#define HORIZON_POISON 2    // 다음 홉인 이웃에게는 그 경로를 무한대로 알림
+
+// 시뮬레이션 설정 (-S key=value,...) - 시간 단위는 ms
+typedef struct SimOptions_ {
+    int delay_min;      // 링크 전달 지연 범위 (링크마다 고정, 같은 링크의 메시지는 보낸 순서대로 도착)
+    int delay_max;
+    int period;         // 주기적 업데이트 간격 (0이면 보내지 않음)
+    int triggered;      // 경로가 바뀌면 바로 알림
+    int horizon;
+    int infinity;       // 0이면 링크 비용 합 + 1 (어떤 경로보다 큼)
+    long long limit;    // 변경 사항 하나를 수렴시키는 최대 시뮬레이션 시간
+} SimOptions;
+
+// 실행 옵션
+typedef struct Options_ {
+    int engine;
+    int stream;     // 상태를 유지하며 변경 사항을 한 번씩만 적용 (-s)
+    int follow;     // 변경 파일 끝에서 새 줄을 기다림 (-f)
+    int threads;    // 동기식 라운드 / Floyd-Warshall에서 사용할 스레드 수 (-j)
+    int delta;      // 라우팅 테이블은 지난번과 달라진 칸만 출력 (-d)
+    BatchOptions batch; // 변경 사항 묶기 (-b N, -w MS)
+    SimOptions sim; // sim 엔진 설정 (-S)
+    const char* daemon;     // 데몬 모드의 Unix 소켓 경로 (-D)
+    const char* save_snapshot;  // 계산한 테이블을 쓸 스냅샷 파일 (--save-snapshot)
+    const char* load_snapshot;  // 처음 계산 대신 읽을 스냅샷 파일 (--load-snapshot)
+} Options;
+
+// 작업 목록 기반 Distance Vector 상태
+// 라우터마다 지난번 이웃에게 알린 뒤 바뀐 목적지 목록(dirty)을 두고,
+// 목록이 비어 있지 않은 라우터만 큐에 넣어 이웃에게 그 목적지들만 다시 알림
+typedef struct DvState_ {
+    Graph graph;        // 현재 링크 상태 (라우터별 이웃 목록)
+    int node_cnt;
+    int* dist;          // dist[x * node_cnt + d]: x에서 d까지의 거리
+    int* next;          // 다음 홉 (-1이면 도달 불가)
+    int* dirty;         // 라우터 x의 바뀐 목적지 목록: dirty[x * node_cnt ...]
+    int* dirty_cnt;
+    char* dirty_mark;   // (x, d)가 목록에 있는지
+    int* queue;         // 알릴 것이 있는 라우터 (원형 큐)
+    int queue_head;
+    int queue_cnt;
+    char* queued;
+    int* stack;         // 링크 비용 증가 시 영향받는 라우터 탐색용
+    char* affected;
+} DvState;
+
+// 동기식 라운드 상태 - 모든 라우터가 이전 라운드 버퍼(cur)만 읽고 다음 버퍼에 기록
+// 라운드가 끝나면(모든 스레드가 모이면) 두 버퍼를 바꿈
+typedef struct SyncDv_ {
+    const Graph* graph;
+    int node_cnt;
+    int* dist[2];
+    int* next[2];
+    int cur;            // 이전 라운드 결과가 있는 버퍼
+    int* changed;       // 스레드별 이번 라운드에 바뀐 경로 수
+} SyncDv;
+
+// 이벤트 기반 DV 프로토콜 시뮬레이션 (-e sim)
+// 링크마다 전달 지연이 있는 메시지를 시간 순서(우선순위 큐)로 배달하고,
+// 라우터는 이웃마다 마지막으로 받은 거리 벡터를 보관해 그중 최소(비용이 같으면 번호가 작은 이웃)를 경로로 고름
+// 주기적 업데이트(전체 벡터)와 경로가 바뀌면 바로 보내는 triggered update(바뀐 목적지만)를 지원하고,
+// 이웃에게 그 이웃을 거치는 경로를 알리지 않거나(split horizon) 무한대로 알림(poisoned reverse)
+// 무한대 이상의 거리는 도달 불가 - 무한대까지 세기(count-to-infinity)도 그대로 일어남
+#define SIM_DELIVER 0       // 이웃의 거리 벡터 도착
+#define SIM_PERIODIC 1      // 주기적 업데이트
+#define SIM_TRIGGER 2       // triggered update
+
+typedef struct SimEvent_ {
+    long long time;
+    long long seq;      // 같은 시각이면 먼저 만든 이벤트부터
+    int type;
+    int from;           // 보낸 라우터 (주기적 / triggered 이벤트는 보낼 라우터)
+    int to;
+    int entry_cnt;
+    int* entries;       // (목적지, 거리) 쌍
+} SimEvent;
+
+typedef struct SimNeighbor_ {
+    int node;
+    int cost;
+    int delay;
+    int* adv;           // 이 이웃이 마지막으로 알려준 거리 (도달 불가는 ROUTE_INFINITY)
+} SimNeighbor;
+
+typedef struct SimRouter_ {
+    SimNeighbor* neighbors;
+    int neighbor_cnt;
+    int neighbor_cap;
+    int* dirty;         // 지난번에 알린 뒤 바뀐 목적지
+    int dirty_cnt;
+    char* dirty_mark;
+    int trigger_pending;
+} SimRouter;
+
+typedef struct DvSim_ {
+    SimOptions opts;
+    const Graph* graph;
+    int node_cnt;
+    SimRouter* routers;
+    int* dist;          // dist[x * node_cnt + d] (도달 불가는 ROUTE_INFINITY)
+    int* next;
+    SimEvent* heap;     // 이벤트 우선순위 큐 (time, seq 순)
+    int heap_cnt;
+    int heap_cap;
+    long long seq;
+    long long now;
+    int infinity;
+    long long in_flight;        // 배달되지 않은 메시지 수
+    int triggers_pending;
+    long long change_start;     // 이번 변경 사항을 적용한 시각
+    long long last_change;      // 마지막으로 경로가 바뀐 시각
+    long long messages;         // 이번 변경 사항에서 보낸 메시지 수
+    long long entries;          // 이번 변경 사항에서 보낸 (목적지, 거리) 수
+    long long route_changes;    // 이번 변경 사항에서 바뀐 경로 수
+    uint64_t rng;
+} DvSim;
+
+// 스트림 모드와 데몬 모드의 엔진 - 링크 상태와 선택한 엔진의 상태를 유지하며 변경 사항을 적용하고 테이블을 계산
+typedef struct StreamEngine_ {
+    const Options* opts;
+    const Topology* topology;
+    DvState state;
+    SyncDv sync;
+    DvSim sim;
+    WorkerPool pool;
+    Arena arena;        // sweep 엔진의 인접 노드 목록 (처음에 한 번 잡음)
+    int* adjacent_nodes;
+} StreamEngine;
+
+void parse_options(int* argc, char** argv, Options* opts);
+void stream_engine_init(StreamEngine* engine, const Options* opts, const Topology* topology, const RouteSnapshot* snapshot);
+void stream_engine_free(StreamEngine* engine);
+void stream_engine_apply(void* ctx, int source, int destination, int distance);
+void stream_engine_compute(void* ctx, int change, RouteTable* table);
+void stream_engine_save(void* ctx, const Link* changes, int change_cnt, const RouteTable* table);
+const RouteSnapshot* open_snapshot(const Options* opts, const Topology* topology, RouteSnapshot* snapshot, int with_changes);
+void save_snapshot(const Options* opts, const Topology* topology, const Link* changes, int change_cnt, const RouteTable* table);
+void run_daemon(const Options* opts, int argc, char** argv);
+void stream_network_changes(const Topology* topology, FILE* changesfile, const ChangeList* changes, OutBuf* out, MessageBatch* messages, const Options* opts, const RouteSnapshot* snapshot);
+void dv_state_init(DvState* state, const Topology* topology);
+void dv_state_free(DvState* state);
+void dv_converge(DvState* state);
+void dv_apply_change(DvState* state, int source, int destination, int distance);
+void dv_store_network(const DvState* state, RouteTable* table);
+void dv_state_seed(DvState* state, const RouteTable* table);
+void dv_mark_dirty(DvState* state, int x, int d);
+void sync_init(SyncDv* sync, const Graph* graph, int thread_cnt);
+void sync_free(SyncDv* sync);
+int sync_converge(SyncDv* sync, WorkerPool* pool);
+void sync_store_network(const SyncDv* sync, RouteTable* table);
+void parse_sim_options(const char* spec, SimOptions* sim);
+void sim_init(DvSim* sim, const Graph* graph, const SimOptions* opts);
+void sim_free(DvSim* sim);
+void sim_apply_change(DvSim* sim, int source, int destination, int distance);
+int sim_converge(DvSim* sim);
+void sim_report(DvSim* sim, int change, int converged);
+void sim_store_network(const DvSim* sim, RouteTable* table);
+void load_network(const Graph* graph, RouteTable* table);
+void process_network_changes(const Options* opts, const Topology* topology, const ChangeList* changes, OutBuf* out, MessageBatch* messages, const RouteSnapshot* snapshot);
+void initialize_network_from_topology(const Topology* topology, RouteTable* table);
+int apply_changes(const ChangeList* changes, RouteTable* table, int change);
+void free_network_memory(RouteTable* table);
+void initnetwork(const Topology* topology, RouteTable* table);
+template <typename T> int change_cnt_rows(RouteTable* table, int* adjacent_nodes);
+int change_cnt_network(RouteTable* table, int* adjacent_nodes);
+void set_infinite_distance(RouteTable* table, int node_1, int node_2);
+int change_network(const ChangeList* changes, RouteTable* table, int change);
+void net_print(OutBuf* out, const RouteTable* table);
 
 int main(int argc, char **argv) {
+    Options opts;
+    parse_options(&argc, argv, &opts);
+    if (opts.daemon) {
+        run_daemon(&opts, argc, argv);
+        return 0;
+    }
+
     if (argc != 4) {
-        printf("usage: distvec topologyfile messagesfile changesfile\n");
+        printf("usage: distvec [-e sweep|worklist|sync|fw|sim] [-S simoptions] [-s] [-f] [-j threads] [-b changes] [-w ms] [-d] [-t] [-c statsfile] [--save-snapshot file] [--load-snapshot file] topologyfile messagesfile changesfile|-\n");
+        printf("       distvec -D socket [-e sweep|worklist|sync|fw|sim] [-S simoptions] [-j threads] [--save-snapshot file] [--load-snapshot file] topologyfile\n");
         exit(0);
     }
 
-    FILE* topology = fopen(argv[1], "r");
+    FILE* topologyfile = fopen(argv[1], "r");
     FILE* messagesfile = fopen(argv[2], "r");
-    FILE* changesfile = fopen(argv[3], "r");
+    FILE* changesfile = open_changes_file(argv[3]);
     FILE* outputfile = fopen("output_dv.txt", "w");
 
     // 파일 열기 오류 처리
-    if (!topology || !messagesfile || !changesfile || !outputfile) {
+    if (!topologyfile || !messagesfile || !changesfile || !outputfile) {
         printf("Error: open input file\n");
-        if (topology) fclose(topology);
+        if (topologyfile) fclose(topologyfile);
         if (messagesfile) fclose(messagesfile);
         if (changesfile) fclose(changesfile);
         if (outputfile) fclose(outputfile);
         exit(0);
     }
 
-    // 네트워크 변경 사항 처리 및 결과 출력
-    process_network_changes(topology, changesfile, outputfile, messagesfile);
-    printf("Complete. Output file written to output_dv.txt.\n");
+    // 입력은 한 번만 읽어 둠 (변경 사항은 stdin이나 follow 모드면 스트림에서 한 줄씩)
+    Topology topology;
+    ChangeList changes = {NULL, 0};
+    MessageBatch messages;
+    int follow_changes = opts.follow || changesfile == stdin;
+    timer_start();
+    int loaded = topology_load(&topology, topologyfile) == 0;
+    if (loaded && !follow_changes) {
+        loaded = changes_load(&changes, changesfile, topology.node_cnt, batch_enabled(&opts.batch)) == 0;
+    }
+    if (loaded && message_batch_load(&messages, messagesfile, topology.node_cnt) != 0) {
+        message_batch_free(&messages);
+        loaded = 0;
+    }
+    timer_add(&phase_timer.parse);
+    stats_start(loaded ? topology.node_cnt : 0);
+
+    if (loaded) {
+        // 처음 상태(변경 사항 0번)는 맞는 스냅샷이 있으면 계산하지 않고 가져옴
+        RouteSnapshot snapshot;
+        const RouteSnapshot* initial = open_snapshot(&opts, &topology, &snapshot, 0);
+
+        // 출력은 버퍼에 모아서 기록
+        OutBuf out;
+        out_init(&out, outputfile, opts.delta);
+
+        // 네트워크 변경 사항 처리 및 결과 출력 (새 엔진들은 링크 상태를 유지하므로 항상 스트림 모드)
+        if (opts.stream || opts.engine != ENGINE_SWEEP) {
+            stream_network_changes(&topology, changesfile, follow_changes ? NULL : &changes, &out, &messages, &opts, initial);
+        } else {
+            process_network_changes(&opts, &topology, &changes, &out, &messages, initial);
+        }
+        if (initial) {
+            snapshot_close(&snapshot);
+        }
+        timer_start();
+        out_free(&out);
+        timer_add(&phase_timer.output);
+        printf("Complete. Output file written to output_dv.txt.\n");
+        timer_report();
+        stats_report();
+        message_batch_free(&messages);
+    }
+    changes_free(&changes);
+    topology_free(&topology);
 
     fclose(outputfile);
     fclose(changesfile);
     fclose(messagesfile);
-    fclose(topology);
+    fclose(topologyfile);
 
     return 0;
 }
 
-void net_print(FILE* outputfile, Node** network, int node_cnt) {
-    for (int i = 0; i < node_cnt; i++) {
-        for (int j = 0; j < node_cnt; j++) {
-            // 거리가 유효한 경우에만 출력
-            if (network[i][j].distance != 999) {
-                fprintf(outputfile, "%c %c %d\n", network[i][j].destination, network[i][j].next, network[i][j].distance);
+// 옵션(-e sweep|worklist|sync|fw|sim, -S 설정, -s, -f, -j N, -b N, -w MS, -d, -t, -c 파일, -D 소켓, --save-snapshot / --load-snapshot 파일)을 읽고 나머지 인자만 argv 앞쪽에 남김
+void parse_options(int* argc, char** argv, Options* opts) {
+    int positional = 1;
+    opts->engine = ENGINE_SWEEP;
+    opts->stream = 0;
+    opts->follow = 0;
+    opts->threads = 1;
+    opts->delta = 0;
+    opts->batch.size = 0;
+    opts->batch.window = 0;
+    opts->daemon = NULL;
+    opts->save_snapshot = NULL;
+    opts->load_snapshot = NULL;
+    opts->sim.delay_min = 1;
+    opts->sim.delay_max = 10;
+    opts->sim.period = 30000;
+    opts->sim.triggered = 1;
+    opts->sim.horizon = HORIZON_POISON;
+    opts->sim.infinity = 0;
+    opts->sim.limit = 3600000;
+    const char* stats_path = NULL;
+
+    for (int i = 1; i < *argc; i++) {
+        if (strcmp(argv[i], "-e") == 0 && i + 1 < *argc) {
+            i++;
+            if (strcmp(argv[i], "sweep") == 0) {
+                opts->engine = ENGINE_SWEEP;
+            } else if (strcmp(argv[i], "worklist") == 0) {
+                opts->engine = ENGINE_WORKLIST;
+            } else if (strcmp(argv[i], "sync") == 0) {
+                opts->engine = ENGINE_SYNC;
+            } else if (strcmp(argv[i], "fw") == 0) {
+                opts->engine = ENGINE_FW;
+            } else if (strcmp(argv[i], "sim") == 0) {
+                opts->engine = ENGINE_SIM;
+            } else {
+                printf("Error: unknown engine %s\n", argv[i]);
+                exit(0);
             }
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < *argc) {
+            opts->threads = atoi(argv[++i]);
+            if (opts->threads < 1) {
+                printf("Error: invalid thread count %s\n", argv[i]);
+                exit(0);
+            }
+        } else if (strcmp(argv[i], "-d") == 0) {
+            opts->delta = 1;
+        } else if (strcmp(argv[i], "-t") == 0) {
+            phase_timer.enabled = 1;
+        } else if (strcmp(argv[i], "-S") == 0 && i + 1 < *argc) {
+            parse_sim_options(argv[++i], &opts->sim);
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < *argc) {
+            stats_path = argv[++i];
+        } else if (strcmp(argv[i], "-D") == 0 && i + 1 < *argc) {
+            opts->daemon = argv[++i];
+        } else if (strcmp(argv[i], "--save-snapshot") == 0 && i + 1 < *argc) {
+            opts->save_snapshot = argv[++i];
+        } else if (strcmp(argv[i], "--load-snapshot") == 0 && i + 1 < *argc) {
+            opts->load_snapshot = argv[++i];
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < *argc) {
+            opts->batch.size = atoi(argv[++i]);
+            if (opts->batch.size < 1) {
+                printf("Error: invalid batch size %s\n", argv[i]);
+                exit(0);
+            }
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < *argc) {
+            opts->batch.window = atoll(argv[++i]);
+            if (opts->batch.window < 1) {
+                printf("Error: invalid batch window %s\n", argv[i]);
+                exit(0);
+            }
+        } else if (strcmp(argv[i], "-s") == 0) {
+            opts->stream = 1;
+        } else if (strcmp(argv[i], "-f") == 0) {
+            opts->stream = 1;
+            opts->follow = 1;
+        } else {
+            argv[positional++] = argv[i];
         }
-        fprintf(outputfile, "\n"); // 각 행의 끝에 개행 문자 출력
+    }
+    *argc = positional;
+    if (stats_path) {
+        stats_enable(stats_path, "distvec", engine_names[opts->engine]);
+    }
+    if ((opts->save_snapshot || opts->load_snapshot) && (opts->engine == ENGINE_SYNC || opts->engine == ENGINE_SIM)) {
+        printf("Error: the %s engine keeps per-round state that snapshots do not hold\n", engine_names[opts->engine]);
+        exit(0);
+    }
+
+    // 변경 사항을 stdin("-")으로 받으면 되감을 수 없으므로 스트림 모드
+    if (positional == 4 && strcmp(argv[3], "-") == 0) {
+        opts->stream = 1;
+    }
+    // 변경 사항을 묶으면 묶음마다 상태를 이어서 계산하므로 스트림 모드
+    if (batch_enabled(&opts->batch)) {
+        opts->stream = 1;
     }
 }
 
+void net_print(OutBuf* out, const RouteTable* table) {
+    out_route_table(out, table); // 거리가 유효한 칸만, 라우터마다 빈 줄로 끝남
+}
+
 // 네트워크 변경 사항 처리 및 결과 출력 함수
-void process_network_changes(FILE* topology, FILE* changesfile, FILE* outputfile, FILE* messagesfile) {
-    Node** network;
-    int node_cnt;
+// 테이블(uint32_t 크기)과 인접 노드 목록은 처음에 arena 하나로 잡아 두고 변경 사항마다 같은 자리에 다시 채움
+void process_network_changes(const Options* opts, const Topology* topology, const ChangeList* changes, OutBuf* out, MessageBatch* messages, const RouteSnapshot* snapshot) {
+    int node_cnt = topology->node_cnt;
+    Arena arena;
+    RouteTable table;
     int change = 0;
 
-    // 초기 파일 위치로 이동하여 노드 수를 읽음
-    rewind(topology);
-    fscanf(topology, "%d\n", &node_cnt);
+    arena_init(&arena, arena_bytes(route_table_bytes(node_cnt)) + arena_bytes(sizeof(int) * node_cnt));
+    route_table_borrow(&table, arena_alloc(&arena, route_table_bytes(node_cnt)), node_cnt);
+    int* adjacent_nodes = (int*)arena_alloc(&arena, sizeof(int) * node_cnt);
 
     // 무한 반복하여 모든 변경 사항 처리
     while (1) {
         // 네트워크 초기화
-        initialize_network_from_topology(topology, &network, node_cnt);
+        initialize_network_from_topology(topology, &table);
 
         // 변경 사항 적용
-        if (change > 0 && apply_changes(changesfile, &network, node_cnt, change) != 0) {
+        if (change > 0 && apply_changes(changes, &table, change) != 0) {
             break;
         }
 
-        // 네트워크 정보 교환 (Distance Vector 알고리즘)
-        while (change_cnt_network(&network, node_cnt) > 0) { }
+        // 네트워크 정보 교환 (Distance Vector 알고리즘) - 처음 상태는 스냅샷이 있으면 그대로 씀
+        if (change == 0 && snapshot) {
+            route_table_copy(&table, &snapshot->table);
+        } else {
+            while (change_cnt_network(&table, adjacent_nodes) > 0) { }
+        }
+        if (change == 0) {
+            save_snapshot(opts, topology, NULL, 0, &table);
+        }
 
         // 현재 상태 출력 및 메시지 전달
-        net_print(outputfile, network, node_cnt);
-        sender_to_reciever(outputfile, messagesfile, network);
+        timer_event();
+        RouteView view = route_view_table(&table);
+        stats_event(&view);
+        net_print(out, &table);
+        timer_add(&phase_timer.output);
+        message_batch_write(out, messages, &view);
+        timer_add(&phase_timer.trace);
+        stats_event_output(out_total(out));
 
-        // 다음 변경 사항으로 진행
+        // 다음 변경 사항으로 진행 (테이블은 다음 초기화에서 같은 블록에 다시 채움)
         change++;
     }
+    arena_free(&arena);
+}
 
-    // 메모리 해제
-    free_network_memory(network, node_cnt);
+// 스냅샷이 있으면 그 상태(변경 사항을 적용한 링크 상태)에서 시작 - 처음 테이블은 호출한 쪽이 스냅샷에서 복사
+void stream_engine_init(StreamEngine* engine, const Options* opts, const Topology* topology, const RouteSnapshot* snapshot) {
+    engine->opts = opts;
+    engine->topology = topology;
+    dv_state_init(&engine->state, topology);
+    if (snapshot) {
+        int source, destination, distance;
+        for (int k = 0; k < snapshot->header->change_cnt; k++) {
+            snapshot_change(snapshot, k, &source, &destination, &distance);
+            graph_apply_change(&engine->state.graph, source, destination, distance);
+        }
+        if (opts->engine == ENGINE_WORKLIST) {
+            dv_state_seed(&engine->state, &snapshot->table);
+        }
+    }
+    arena_init(&engine->arena, arena_bytes(sizeof(int) * topology->node_cnt));
+    engine->adjacent_nodes = (int*)arena_alloc(&engine->arena, sizeof(int) * topology->node_cnt);
+    if (opts->engine == ENGINE_SYNC || opts->engine == ENGINE_FW) {
+        pool_init(&engine->pool, opts->threads);
+    }
+    if (opts->engine == ENGINE_SYNC) {
+        sync_init(&engine->sync, &engine->state.graph, engine->pool.thread_cnt);
+    }
+    if (opts->engine == ENGINE_SIM) {
+        sim_init(&engine->sim, &engine->state.graph, &opts->sim);
+    }
 }
 
-// 네트워크를 토폴로지 파일로부터 초기화하는 함수
-void initialize_network_from_topology(FILE* topology, Node*** network, int node_cnt) {
-    rewind(topology);
-    fscanf(topology, "%d\n", &node_cnt);
-    initnetwork(topology, network, node_cnt);
+void stream_engine_free(StreamEngine* engine) {
+    if (engine->opts->engine == ENGINE_SYNC) {
+        sync_free(&engine->sync);
+    }
+    if (engine->opts->engine == ENGINE_SIM) {
+        sim_free(&engine->sim);
+    }
+    if (engine->opts->engine == ENGINE_SYNC || engine->opts->engine == ENGINE_FW) {
+        pool_free(&engine->pool);
+    }
+    dv_state_free(&engine->state);
+    arena_free(&engine->arena);
 }
 
-// 변경 사항을 적용하는 함수
-int apply_changes(FILE* changesfile, Node*** network, int node_cnt, int change) {
-    return change_network(changesfile, network, node_cnt, change);
+// 변경 사항 하나 적용
+void stream_engine_apply(void* ctx, int source, int destination, int distance) {
+    StreamEngine* engine = (StreamEngine*)ctx;
+    if (engine->opts->engine == ENGINE_WORKLIST) {
+        dv_apply_change(&engine->state, source, destination, distance);
+    } else if (engine->opts->engine == ENGINE_SIM) {
+        sim_apply_change(&engine->sim, source, destination, distance);
+    } else {
+        graph_apply_change(&engine->state.graph, source, destination, distance);
+    }
 }
 
-// 네트워크 메모리를 해제하는 함수
-void free_network_memory(Node** network, int node_cnt) {
-    for (int i = 0; i < node_cnt; i++) {
-        free(network[i]);
+// 네트워크 정보 교환 (Distance Vector 알고리즘) 후 라우팅 테이블 기록
+void stream_engine_compute(void* ctx, int change, RouteTable* table) {
+    StreamEngine* engine = (StreamEngine*)ctx;
+    if (engine->opts->engine == ENGINE_WORKLIST) {
+        dv_converge(&engine->state);
+        dv_store_network(&engine->state, table);
+    } else if (engine->opts->engine == ENGINE_SYNC) {
+        int rounds = sync_converge(&engine->sync, &engine->pool);
+        printf("change %d: converged in %d rounds\n", change, rounds);
+        sync_store_network(&engine->sync, table);
+    } else if (engine->opts->engine == ENGINE_SIM) {
+        sim_report(&engine->sim, change, sim_converge(&engine->sim));
+        sim_store_network(&engine->sim, table);
+    } else if (engine->opts->engine == ENGINE_FW) {
+        load_network(&engine->state.graph, table);
+        floyd_warshall(table, &engine->pool);
+    } else {
+        load_network(&engine->state.graph, table);
+        while (change_cnt_network(table, engine->adjacent_nodes) > 0) { }
     }
-    free(network);
 }
 
-// 네트워크 초기화 함수
-void initnetwork(FILE* topology, Node*** network, int node_cnt) {
-    // 네트워크 메모리 할당
-    *network = (Node**)malloc(sizeof(Node*) * node_cnt);
-    for (int i = 0; i < node_cnt; i++) {
-        (*network)[i] = (Node*)malloc(sizeof(Node) * node_cnt);
+// 스트림 모드 - 토폴로지는 한 번만 읽어 링크 상태를 유지하고, 변경 사항은 한 줄씩 한 번만 적용
+// sweep 엔진은 변경 사항마다 유지 중인 링크 상태로 테이블을 다시 채우고 수렴시키며,
+// worklist 엔진은 이전 테이블에서 바뀐 경로만 다시 수렴시키고,
+// sync 엔진은 링크 상태로 다시 채운 테이블에서 동기식 라운드를 돌려 수렴까지 걸린 라운드 수를 알림
+// sim 엔진은 프로토콜 메시지를 시뮬레이션해 변경 사항마다 수렴 시간과 메시지 수를 알림
+// fw 엔진은 링크 상태로 다시 채운 테이블에서 Floyd-Warshall로 모든 쌍의 최단 경로를 구함
+// 지금 상태를 스냅샷으로 씀 (changes: 토폴로지 이후 적용한 변경 사항들)
+void stream_engine_save(void* ctx, const Link* changes, int change_cnt, const RouteTable* table) {
+    StreamEngine* engine = (StreamEngine*)ctx;
+    save_snapshot(engine->opts, engine->topology, changes, change_cnt, table);
+}
+
+// --load-snapshot 파일을 열어 지금 입력에 맞는지 확인 - 맞지 않으면 NULL (처음부터 계산)
+// with_changes가 0이면 변경 사항이 반영되지 않은 처음 상태의 스냅샷만 받음 (배치/스트림 모드는 변경 사항마다 출력하므로)
+const RouteSnapshot* open_snapshot(const Options* opts, const Topology* topology, RouteSnapshot* snapshot, int with_changes) {
+    if (!opts->load_snapshot || snapshot_open(snapshot, opts->load_snapshot, "distvec", engine_names[opts->engine], topology) != 0) {
+        return NULL;
+    }
+    if (!with_changes && snapshot->header->change_cnt > 0) {
+        printf("Snapshot %s not loaded: holds applied changes, only the daemon resumes from those\n", opts->load_snapshot);
+        snapshot_close(snapshot);
+        return NULL;
+    }
+    printf("Loaded snapshot %s (%d changes)\n", opts->load_snapshot, snapshot->header->change_cnt);
+    return snapshot;
+}
+
+// --save-snapshot 파일에 테이블을 씀
+void save_snapshot(const Options* opts, const Topology* topology, const Link* changes, int change_cnt, const RouteTable* table) {
+    if (opts->save_snapshot) {
+        snapshot_save(opts->save_snapshot, "distvec", engine_names[opts->engine], topology, changes, change_cnt, table, NULL);
+    }
+}
+
+void stream_network_changes(const Topology* topology, FILE* changesfile, const ChangeList* changes, OutBuf* out, MessageBatch* messages, const Options* opts, const RouteSnapshot* snapshot) {
+    StreamEngine engine;
+    RouteTable table;
+    ChangeStream stream;
+    ChangeBatch batch;
+
+    stream_engine_init(&engine, opts, topology, snapshot);
+    route_table_init(&table, engine.state.graph.node_cnt, graph_max_weight(&engine.state.graph));
+    change_stream_init(&stream, changesfile, changes, topology->node_cnt, opts->follow);
+
+    change_batch_init(&batch, &opts->batch);
+
+    // 변경 사항 묶음마다 (묶지 않으면 변경 사항 하나마다) 한 번 계산하고 출력
+    for (int change = 0; ; change++) {
+        if (change != 0) {
+            if (!change_batch_next(&batch, &stream)) {
+                break;
+            }
+            for (int k = 0; k < batch.change_cnt; k++) {
+                int distance = batch.changes[k].cost;
+                if (distance >= 0 && distance < LINK_NONE) {
+                    route_table_reserve(&table, distance);
+                }
+            }
+            int net_cnt = change_batch_coalesce(&batch, &engine.state.graph);
+            for (int k = 0; k < net_cnt; k++) {
+                stream_engine_apply(&engine, batch.net[k].src, batch.net[k].dst, batch.net[k].cost);
+            }
+        }
+
+        if (change == 0 && snapshot) {
+            route_table_copy(&table, &snapshot->table);
+        } else {
+            stream_engine_compute(&engine, change, &table);
+        }
+        if (change == 0) {
+            stream_engine_save(&engine, NULL, 0, &table);
+        }
+        timer_event();
+        RouteView view = route_view_table(&table);
+        stats_event(&view);
+        net_print(out, &table);
+        timer_add(&phase_timer.output);
+        message_batch_write(out, messages, &view);
+        timer_add(&phase_timer.trace);
+        stats_event_output(out_total(out));
+        out_flush(out); // 변경 사항마다 결과를 바로 볼 수 있도록
+        timer_add(&phase_timer.output);
+    }
+
+    change_batch_report(&batch);
+    change_batch_free(&batch);
+    change_stream_free(&stream);
+    free_network_memory(&table);
+    stream_engine_free(&engine);
+}
+
+// 데몬 모드 - 토폴로지만 읽고 변경 사항과 질의는 소켓으로 받음 (재계산은 백그라운드 스레드)
+void run_daemon(const Options* opts, int argc, char** argv) {
+    if (argc != 2) {
+        printf("usage: distvec -D socket [-e sweep|worklist|sync|fw|sim] [-S simoptions] [-j threads] [--save-snapshot file] [--load-snapshot file] topologyfile\n");
+        exit(0);
+    }
+    FILE* topologyfile = fopen(argv[1], "r");
+    if (!topologyfile) {
+        printf("Error: open input file\n");
+        exit(0);
+    }
+    Topology topology;
+    int loaded = topology_load(&topology, topologyfile) == 0;
+    fclose(topologyfile);
+    if (!loaded) {
+        topology_free(&topology);
+        exit(0);
+    }
+
+    // 스냅샷이 있으면 그 변경 사항들까지 반영된 상태에서 이어 감
+    RouteSnapshot snapshot;
+    const RouteSnapshot* initial = open_snapshot(opts, &topology, &snapshot, 1);
+    ChangeList history = {NULL, 0};
+    if (initial) {
+        history.change_cnt = initial->header->change_cnt;
+        history.changes = (Link*)malloc(sizeof(Link) * (history.change_cnt > 0 ? history.change_cnt : 1));
+        for (int k = 0; k < history.change_cnt; k++) {
+            snapshot_change(initial, k, &history.changes[k].src, &history.changes[k].dst, &history.changes[k].cost);
+            history.changes[k].line = 0;
+        }
+    }
+
+    StreamEngine engine;
+    stream_engine_init(&engine, opts, &topology, initial);
+    DaemonEngine daemon_engine = {&engine, stream_engine_apply, stream_engine_compute, opts->save_snapshot ? stream_engine_save : NULL,
+                                  initial ? &initial->table : NULL, history.changes, history.change_cnt};
+    int max_weight = graph_max_weight(&engine.state.graph);
+    if (initial && initial->table.max_weight > max_weight) {
+        max_weight = initial->table.max_weight;
+    }
+    daemon_run(opts->daemon, engine.state.graph.node_cnt, max_weight, &daemon_engine);
+    stream_engine_free(&engine);
+    if (initial) {
+        snapshot_close(&snapshot);
+    }
+    changes_free(&history);
+    topology_free(&topology);
+}
+
+void sync_init(SyncDv* sync, const Graph* graph, int thread_cnt) {
+    size_t cells = (size_t)graph->node_cnt * graph->node_cnt;
+    if (cells == 0) {
+        cells = 1;
     }
+    sync->graph = graph;
+    sync->node_cnt = graph->node_cnt;
+    for (int b = 0; b < 2; b++) {
+        sync->dist[b] = (int*)malloc(sizeof(int) * cells);
+        sync->next[b] = (int*)malloc(sizeof(int) * cells);
+    }
+    sync->cur = 0;
+    sync->changed = (int*)calloc(thread_cnt, sizeof(int));
+}
+
+void sync_free(SyncDv* sync) {
+    for (int b = 0; b < 2; b++) {
+        free(sync->dist[b]);
+        free(sync->next[b]);
+    }
+    free(sync->changed);
+}
+
+// 라우터 x의 새 벡터 계산: 각 목적지마다 이웃 u의 이전 라운드 거리 + 링크 비용 중 최소
+// 비용이 같으면 번호가 작은 이웃을 골라 스레드 수와 상관없이 같은 결과가 나옴
+static void sync_row_task(void* ctx, int worker, int x) {
+    SyncDv* sync = (SyncDv*)ctx;
+    const Graph* graph = sync->graph;
+    int node_cnt = sync->node_cnt;
+    const int* old_dist = sync->dist[sync->cur];
+    const int* old_next = sync->next[sync->cur] + (size_t)x * node_cnt;
+    int* new_dist = sync->dist[1 - sync->cur] + (size_t)x * node_cnt;
+    int* new_next = sync->next[1 - sync->cur] + (size_t)x * node_cnt;
+
+    for (int d = 0; d < node_cnt; d++) {
+        new_dist[d] = d == x ? 0 : ROUTE_INFINITY;
+        new_next[d] = d == x ? x : -1;
+    }
+    for (int k = graph->offset[x]; k < graph->offset[x] + graph->degree[x]; k++) {
+        int u = graph->adj[k];
+        int cost = graph->weight[k];
+        const int* u_dist = old_dist + (size_t)u * node_cnt;
+        for (int d = 0; d < node_cnt; d++) {
+            int new_distance = route_add(u_dist[d], cost);
+            if (d == x || new_distance >= ROUTE_INFINITY) {
+                continue;
+            }
+            if (new_distance < new_dist[d] || (new_distance == new_dist[d] && u < new_next[d])) {
+                new_dist[d] = new_distance;
+                new_next[d] = u;
+            }
+        }
+    }
+
+    const int* x_old_dist = old_dist + (size_t)x * node_cnt;
+    for (int d = 0; d < node_cnt; d++) {
+        if (new_dist[d] != x_old_dist[d] || new_next[d] != old_next[d]) {
+            sync->changed[worker]++;
+        }
+    }
+}
+
+// 링크 상태로 테이블을 채우고 바뀌는 경로가 없을 때까지 라운드 반복
+// 각 라운드는 행을 스레드에 나눠 계산하고, pool_run이 모두 끝나기를 기다리는 것이 라운드 사이의 장벽
+// 반환 값: 경로가 바뀐 라운드 수
+int sync_converge(SyncDv* sync, WorkerPool* pool) {
+    const Graph* graph = sync->graph;
+    int node_cnt = sync->node_cnt;
+    int* dist = sync->dist[0];
+    int* next = sync->next[0];
 
-   // 각 노드 초기화
     for (int i = 0; i < node_cnt; i++) {
         for (int j = 0; j < node_cnt; j++) {
-            (*network)[i][j].destination = (char)('0' + j); // 목적지 노드 설정
+            dist[(size_t)i * node_cnt + j] = i == j ? 0 : ROUTE_INFINITY;
+            next[(size_t)i * node_cnt + j] = i == j ? i : -1;
+        }
+        for (int k = graph->offset[i]; k < graph->offset[i] + graph->degree[i]; k++) {
+            dist[(size_t)i * node_cnt + graph->adj[k]] = graph->weight[k];
+            next[(size_t)i * node_cnt + graph->adj[k]] = graph->adj[k];
+        }
+    }
+    sync->cur = 0;
 
-            if (i == j) {
-                // 자기 자신인 경우
-                (*network)[i][j].distance = 0;
-                (*network)[i][j].next = (char)('0' + i);
+    for (int rounds = 0; ; rounds++) {
+        for (int w = 0; w < pool->thread_cnt; w++) {
+            sync->changed[w] = 0;
+        }
+        pool_run(pool, node_cnt, sync_row_task, sync);
+        sync->cur = 1 - sync->cur; // 버퍼 교체
+
+        int changed = 0;
+        for (int w = 0; w < pool->thread_cnt; w++) {
+            changed += sync->changed[w];
+        }
+        STAT_ADD(STAT_SWEEPS, 1);
+        STAT_ADD(STAT_RELAXATIONS, changed);
+        if (changed == 0) {
+            return rounds;
+        }
+    }
+}
+
+// 동기식 라운드의 결과를 라우팅 테이블에 기록
+void sync_store_network(const SyncDv* sync, RouteTable* table) {
+    for (int i = 0; i < sync->node_cnt; i++) {
+        size_t row = (size_t)i * sync->node_cnt;
+        route_store_row(table, i, sync->dist[sync->cur] + row, sync->next[sync->cur] + row);
+    }
+}
+
+// -S 설정 읽기: delay=MIN:MAX, period=MS, triggered=0|1, horizon=none|split|poison, infinity=N, limit=MS
+void parse_sim_options(const char* spec, SimOptions* sim) {
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "%s", spec);
+    for (char* item = strtok(buffer, ","); item; item = strtok(NULL, ",")) {
+        char* value = strchr(item, '=');
+        if (!value) {
+            printf("Error: invalid simulation option %s\n", item);
+            exit(0);
+        }
+        *value++ = '\0';
+        if (strcmp(item, "delay") == 0) {
+            if (sscanf(value, "%d:%d", &sim->delay_min, &sim->delay_max) != 2) {
+                sim->delay_min = sim->delay_max = atoi(value);
+            }
+        } else if (strcmp(item, "period") == 0) {
+            sim->period = atoi(value);
+        } else if (strcmp(item, "triggered") == 0) {
+            sim->triggered = atoi(value);
+        } else if (strcmp(item, "horizon") == 0) {
+            if (strcmp(value, "none") == 0) {
+                sim->horizon = HORIZON_NONE;
+            } else if (strcmp(value, "split") == 0) {
+                sim->horizon = HORIZON_SPLIT;
+            } else if (strcmp(value, "poison") == 0) {
+                sim->horizon = HORIZON_POISON;
             } else {
-                // 다른 노드인 경우
-                (*network)[i][j].distance = 999; // 무한대 의미
-                (*network)[i][j].next = '-';     // 연결 없음
+                printf("Error: unknown horizon %s\n", value);
+                exit(0);
             }
+        } else if (strcmp(item, "infinity") == 0) {
+            sim->infinity = atoi(value);
+        } else if (strcmp(item, "limit") == 0) {
+            sim->limit = atoll(value);
+        } else {
+            printf("Error: invalid simulation option %s\n", item);
+            exit(0);
         }
     }
+    if (sim->delay_min < 0 || sim->delay_max < sim->delay_min || sim->period < 0 || sim->infinity < 0 ||
+        sim->limit <= 0 || (!sim->triggered && sim->period == 0)) {
+        printf("Error: invalid simulation options %s\n", spec);
+        exit(0);
+    }
+}
+
+// 링크 (u, v)의 전달 지연 - 양방향 같은 값, 실행마다 같은 값
+static int sim_link_delay(const DvSim* sim, int u, int v) {
+    int span = sim->opts.delay_max - sim->opts.delay_min;
+    if (span == 0) {
+        return sim->opts.delay_min;
+    }
+    uint64_t key = (uint64_t)(u < v ? u : v) << 32 | (uint32_t)(u < v ? v : u);
+    key *= 0x9E3779B97F4A7C15ull;
+    return sim->opts.delay_min + (int)((key >> 33) % (uint64_t)(span + 1));
+}
 
-    // 토폴로지 파일에서 네트워크 정보 읽기
-    int src, dst, distance;
-    while (fscanf(topology, "%d %d %d\n", &src, &dst, &distance) != EOF) {
-        (*network)[src][dst].distance = distance;        // 거리 설정
-        (*network)[src][dst].next = (char)('0' + dst);   // 다음 홉 설정
-        (*network)[dst][src].distance = distance;        // 양방향 거리 설정
-        (*network)[dst][src].next = (char)('0' + src);   // 양방향 다음 홉 설정
+static void sim_heap_push(DvSim* sim, SimEvent event) {
+    if (sim->heap_cnt == sim->heap_cap) {
+        sim->heap_cap = sim->heap_cap ? sim->heap_cap * 2 : 256;
+        sim->heap = (SimEvent*)realloc(sim->heap, sizeof(SimEvent) * sim->heap_cap);
+    }
+    event.seq = sim->seq++;
+    int i = sim->heap_cnt++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        const SimEvent* p = &sim->heap[parent];
+        if (p->time < event.time || (p->time == event.time && p->seq < event.seq)) {
+            break;
+        }
+        sim->heap[i] = *p;
+        i = parent;
     }
+    sim->heap[i] = event;
 }
 
-int change_cnt_network(Node*** network, int node_cnt) {
+static SimEvent sim_heap_pop(DvSim* sim) {
+    SimEvent top = sim->heap[0];
+    SimEvent last = sim->heap[--sim->heap_cnt];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= sim->heap_cnt) {
+            break;
+        }
+        if (child + 1 < sim->heap_cnt) {
+            const SimEvent* a = &sim->heap[child + 1];
+            const SimEvent* b = &sim->heap[child];
+            if (a->time < b->time || (a->time == b->time && a->seq < b->seq)) {
+                child++;
+            }
+        }
+        const SimEvent* c = &sim->heap[child];
+        if (last.time < c->time || (last.time == c->time && last.seq < c->seq)) {
+            break;
+        }
+        sim->heap[i] = *c;
+        i = child;
+    }
+    if (sim->heap_cnt > 0) {
+        sim->heap[i] = last;
+    }
+    return top;
+}
+
+static SimNeighbor* sim_find_neighbor(DvSim* sim, int x, int u) {
+    SimRouter* router = &sim->routers[x];
+    for (int i = 0; i < router->neighbor_cnt; i++) {
+        if (router->neighbors[i].node == u) {
+            return &router->neighbors[i];
+        }
+    }
+    return NULL;
+}
+
+// 이웃 추가 - 아직 아무것도 듣지 못했으므로 모든 목적지가 도달 불가
+static SimNeighbor* sim_add_neighbor(DvSim* sim, int x, int u, int cost) {
+    SimRouter* router = &sim->routers[x];
+    if (router->neighbor_cnt == router->neighbor_cap) {
+        router->neighbor_cap = router->neighbor_cap ? router->neighbor_cap * 2 : 4;
+        router->neighbors = (SimNeighbor*)realloc(router->neighbors, sizeof(SimNeighbor) * router->neighbor_cap);
+    }
+    SimNeighbor* neighbor = &router->neighbors[router->neighbor_cnt++];
+    neighbor->node = u;
+    neighbor->cost = cost;
+    neighbor->delay = sim_link_delay(sim, x, u);
+    neighbor->adv = (int*)malloc(sizeof(int) * sim->node_cnt);
+    for (int d = 0; d < sim->node_cnt; d++) {
+        neighbor->adv[d] = ROUTE_INFINITY;
+    }
+    return neighbor;
+}
+
+static void sim_remove_neighbor(DvSim* sim, int x, int u) {
+    SimRouter* router = &sim->routers[x];
+    for (int i = 0; i < router->neighbor_cnt; i++) {
+        if (router->neighbors[i].node == u) {
+            free(router->neighbors[i].adv);
+            router->neighbors[i] = router->neighbors[--router->neighbor_cnt];
+            return;
+        }
+    }
+}
+
+// 라우터 x의 목적지 d가 바뀌었음을 기록하고 triggered update 예약
+static void sim_mark_dirty(DvSim* sim, int x, int d) {
+    SimRouter* router = &sim->routers[x];
+    if (!router->dirty_mark[d]) {
+        router->dirty_mark[d] = 1;
+        router->dirty[router->dirty_cnt++] = d;
+    }
+    if (sim->opts.triggered && !router->trigger_pending) {
+        SimEvent event = {sim->now, 0, SIM_TRIGGER, x, x, 0, NULL};
+        router->trigger_pending = 1;
+        sim->triggers_pending++;
+        sim_heap_push(sim, event);
+    }
+}
+
+// 라우터 x의 목적지 d 경로를 이웃들이 알려준 거리로 다시 고름, 바뀌면 1
+static int sim_recompute(DvSim* sim, int x, int d) {
+    if (x == d) {
+        return 0;
+    }
+    const SimRouter* router = &sim->routers[x];
+    int best = ROUTE_INFINITY, hop = -1;
+    for (int i = 0; i < router->neighbor_cnt; i++) {
+        const SimNeighbor* neighbor = &router->neighbors[i];
+        int distance = route_add(neighbor->adv[d], neighbor->cost);
+        if (distance >= sim->infinity) {
+            continue;
+        }
+        if (distance < best || (distance == best && neighbor->node < hop)) {
+            best = distance;
+            hop = neighbor->node;
+        }
+    }
+    size_t cell = (size_t)x * sim->node_cnt + d;
+    if (sim->dist[cell] == best && sim->next[cell] == hop) {
+        return 0;
+    }
+    sim->dist[cell] = best;
+    sim->next[cell] = hop;
+    sim->last_change = sim->now;
+    sim->route_changes++;
+    sim_mark_dirty(sim, x, d);
+    return 1;
+}
+
+// 라우터 x가 이웃 모두에게 거리 벡터를 보냄 (full이면 전체, 아니면 바뀐 목적지만)
+static void sim_send(DvSim* sim, int x, int full) {
+    SimRouter* router = &sim->routers[x];
+    int node_cnt = sim->node_cnt;
+    int count = full ? node_cnt : router->dirty_cnt;
+    const int* dist = sim->dist + (size_t)x * node_cnt;
+    const int* next = sim->next + (size_t)x * node_cnt;
+
+    for (int i = 0; i < router->neighbor_cnt; i++) {
+        const SimNeighbor* neighbor = &router->neighbors[i];
+        int* entries = (int*)malloc(sizeof(int) * 2 * (count > 0 ? count : 1));
+        int entry_cnt = 0;
+        for (int k = 0; k < count; k++) {
+            int d = full ? k : router->dirty[k];
+            int metric = dist[d] >= sim->infinity ? sim->infinity : dist[d];
+            if (d != x && next[d] == neighbor->node) {
+                // split horizon: 이웃이 가진 예전 경로는 타임아웃으로 지워지는데, 경로가 이 이웃으로 바뀐
+                // 직후 한 번만 도달 불가로 알리는 것으로 대신함 (그 뒤로는 보내지 않음)
+                if (sim->opts.horizon == HORIZON_SPLIT && !router->dirty_mark[d]) {
+                    continue;
+                }
+                if (sim->opts.horizon != HORIZON_NONE) {
+                    metric = sim->infinity;
+                }
+            }
+            entries[2 * entry_cnt] = d;
+            entries[2 * entry_cnt + 1] = metric;
+            entry_cnt++;
+        }
+        if (entry_cnt == 0 && !full) {
+            free(entries);
+            continue;
+        }
+        SimEvent event = {sim->now + neighbor->delay, 0, SIM_DELIVER, x, neighbor->node, entry_cnt, entries};
+        sim_heap_push(sim, event);
+        sim->in_flight++;
+        sim->messages++;
+        sim->entries += entry_cnt;
+    }
+
+    for (int k = 0; k < router->dirty_cnt; k++) {
+        router->dirty_mark[router->dirty[k]] = 0;
+    }
+    router->dirty_cnt = 0;
+}
+
+// 이웃 from의 거리 벡터가 to에 도착 (그 사이 링크가 끊겼으면 버림)
+static void sim_deliver(DvSim* sim, const SimEvent* event) {
+    SimNeighbor* neighbor = sim_find_neighbor(sim, event->to, event->from);
+    if (!neighbor) {
+        return;
+    }
+    size_t row = (size_t)event->to * sim->node_cnt;
+    for (int k = 0; k < event->entry_cnt; k++) {
+        int d = event->entries[2 * k];
+        int metric = event->entries[2 * k + 1];
+        neighbor->adv[d] = metric >= sim->infinity ? ROUTE_INFINITY : metric;
+        // 지금 경로의 다음 홉이 보낸 이웃이거나, 보낸 이웃을 거치는 경로가 지금보다 짧거나 같을 때만 다시 고름
+        if (sim->next[row + d] == event->from || route_add(neighbor->adv[d], neighbor->cost) <= sim->dist[row + d]) {
+            sim_recompute(sim, event->to, d);
+        }
+    }
+}
+
+// 링크 비용 합 + 1 (어떤 단순 경로의 비용보다 큼) - 늘어나기만 함
+static void sim_update_infinity(DvSim* sim) {
+    if (sim->opts.infinity > 0) {
+        sim->infinity = sim->opts.infinity;
+        return;
+    }
+    long long total = 1;
+    for (int x = 0; x < sim->node_cnt; x++) {
+        for (int i = 0; i < sim->routers[x].neighbor_cnt; i++) {
+            if (x < sim->routers[x].neighbors[i].node) {
+                total += sim->routers[x].neighbors[i].cost;
+            }
+        }
+    }
+    if (total > INT_MAX / 2) {
+        total = INT_MAX / 2;
+    }
+    if (total > sim->infinity) {
+        sim->infinity = (int)total;
+    }
+}
+
+// 처음 상태: 라우터는 자기 자신까지의 경로만 알고, 시각 0에 모두 이웃에게 알림
+void sim_init(DvSim* sim, const Graph* graph, const SimOptions* opts) {
+    int node_cnt = sim->node_cnt = graph->node_cnt;
+    size_t cells = (size_t)node_cnt * node_cnt;
+    sim->opts = *opts;
+    sim->graph = graph;
+    sim->routers = (SimRouter*)calloc(node_cnt > 0 ? node_cnt : 1, sizeof(SimRouter));
+    sim->dist = (int*)malloc(sizeof(int) * (cells > 0 ? cells : 1));
+    sim->next = (int*)malloc(sizeof(int) * (cells > 0 ? cells : 1));
+    sim->heap = NULL;
+    sim->heap_cnt = sim->heap_cap = 0;
+    sim->seq = 0;
+    sim->now = 0;
+    sim->infinity = 0;
+    sim->in_flight = 0;
+    sim->triggers_pending = 0;
+    sim->change_start = sim->last_change = 0;
+    sim->messages = sim->entries = sim->route_changes = 0;
+    sim->rng = 0x2545F4914F6CDD1Dull;
+
+    for (int x = 0; x < node_cnt; x++) {
+        SimRouter* router = &sim->routers[x];
+        router->dirty = (int*)malloc(sizeof(int) * node_cnt);
+        router->dirty_mark = (char*)calloc(node_cnt, 1);
+        for (int k = graph->offset[x]; k < graph->offset[x] + graph->degree[x]; k++) {
+            sim_add_neighbor(sim, x, graph->adj[k], graph->weight[k]);
+        }
+        for (int d = 0; d < node_cnt; d++) {
+            sim->dist[(size_t)x * node_cnt + d] = d == x ? 0 : ROUTE_INFINITY;
+            sim->next[(size_t)x * node_cnt + d] = d == x ? x : -1;
+        }
+    }
+    sim_update_infinity(sim);
+
+    for (int x = 0; x < node_cnt; x++) {
+        sim_mark_dirty(sim, x, x);
+        if (opts->period > 0) {
+            // 라우터마다 첫 주기적 업데이트 시각을 흩어 놓음 (모두 같은 순간에 보내지 않도록)
+            sim->rng ^= sim->rng << 13;
+            sim->rng ^= sim->rng >> 7;
+            sim->rng ^= sim->rng << 17;
+            SimEvent event = {(long long)(sim->rng % (uint64_t)opts->period), 0, SIM_PERIODIC, x, x, 0, NULL};
+            sim_heap_push(sim, event);
+        }
+    }
+}
+
+void sim_free(DvSim* sim) {
+    for (int x = 0; x < sim->node_cnt; x++) {
+        SimRouter* router = &sim->routers[x];
+        for (int i = 0; i < router->neighbor_cnt; i++) {
+            free(router->neighbors[i].adv);
+        }
+        free(router->neighbors);
+        free(router->dirty);
+        free(router->dirty_mark);
+    }
+    for (int i = 0; i < sim->heap_cnt; i++) {
+        free(sim->heap[i].entries);
+    }
+    free(sim->heap);
+    free(sim->routers);
+    free(sim->dist);
+    free(sim->next);
+}
+
+// 변경 사항 하나를 그래프에 적용하고 양 끝 라우터가 바로 알아챔 (링크 감지는 지연 없음)
+void sim_apply_change(DvSim* sim, int source, int destination, int distance) {
+    if (!graph_apply_change((Graph*)sim->graph, source, destination, distance)) {
+        return;
+    }
+    int cost = graph_link_cost(sim->graph, source, destination);
+    for (int dir = 0; dir < 2; dir++) {
+        int x = dir == 0 ? source : destination;
+        int u = dir == 0 ? destination : source;
+        SimNeighbor* neighbor = sim_find_neighbor(sim, x, u);
+        if (cost >= LINK_NONE) {
+            sim_remove_neighbor(sim, x, u);
+        } else if (neighbor) {
+            neighbor->cost = cost;
+        } else {
+            // 새 이웃에게는 전체 벡터를 알림
+            sim_add_neighbor(sim, x, u, cost);
+            for (int d = 0; d < sim->node_cnt; d++) {
+                sim_mark_dirty(sim, x, d);
+            }
+        }
+        for (int d = 0; d < sim->node_cnt; d++) {
+            sim_recompute(sim, x, d);
+        }
+    }
+    sim_update_infinity(sim);
+}
+
+// 수렴할 때까지 이벤트 처리, 수렴했으면 1
+// 배달 중인 메시지와 예약된 triggered update가 없으면 수렴
+// triggered update를 끈 경우에는 주기적 업데이트가 늘 배달 중이므로, 마지막으로 경로가 바뀐 뒤
+// 한 주기 + 최대 지연 동안 더 바뀌지 않으면 수렴 (그 사이 모든 라우터의 전체 벡터가 도착함)
+int sim_converge(DvSim* sim) {
+    long long start = sim->change_start;
+    while (sim->heap_cnt > 0) {
+        const SimEvent* top = &sim->heap[0];
+        if (sim->opts.triggered ? sim->in_flight == 0 && sim->triggers_pending == 0
+                                : top->time - sim->last_change > (long long)sim->opts.period + sim->opts.delay_max) {
+            return 1;
+        }
+        if (top->time - start > sim->opts.limit) {
+            return 0;
+        }
+        SimEvent event = sim_heap_pop(sim);
+        sim->now = event.time;
+        if (event.type == SIM_DELIVER) {
+            sim->in_flight--;
+            sim_deliver(sim, &event);
+            free(event.entries);
+        } else if (event.type == SIM_TRIGGER) {
+            sim->routers[event.from].trigger_pending = 0;
+            sim->triggers_pending--;
+            sim_send(sim, event.from, 0);
+        } else {
+            sim_send(sim, event.from, 1);
+            event.time += sim->opts.period;
+            sim_heap_push(sim, event);
+        }
+    }
+    return 1;
+}
+
+// 변경 사항 하나의 수렴 시간(변경부터 마지막 경로 변화까지)과 메시지 수를 알리고 다음 변경 사항 준비
+void sim_report(DvSim* sim, int change, int converged) {
+    if (converged) {
+        printf("change %d: converged in %lld ms", change, sim->last_change - sim->change_start);
+    } else {
+        printf("change %d: not converged within %lld ms", change, sim->opts.limit);
+    }
+    printf(" (%lld messages, %lld routes sent, %lld route changes)\n", sim->messages, sim->entries, sim->route_changes);
+    STAT_ADD(STAT_UPDATES, sim->messages);
+    STAT_ADD(STAT_RELAXATIONS, sim->route_changes);
+    sim->messages = sim->entries = sim->route_changes = 0;
+    sim->change_start = sim->last_change = sim->now;
+}
+
+void sim_store_network(const DvSim* sim, RouteTable* table) {
+    for (int i = 0; i < sim->node_cnt; i++) {
+        size_t row = (size_t)i * sim->node_cnt;
+        route_store_row(table, i, sim->dist + row, sim->next + row);
+    }
+}
+
+// 토폴로지를 읽고 각 라우터가 자기 자신까지의 경로(거리 0)만 아는 상태에서 시작
+void dv_state_init(DvState* state, const Topology* topology) {
+    graph_load(topology, &state->graph);
+    int node_cnt = state->node_cnt = state->graph.node_cnt;
+    size_t cells = (size_t)node_cnt * node_cnt;
+    if (cells == 0) {
+        cells = 1;
+    }
+    state->dist = (int*)malloc(sizeof(int) * cells);
+    state->next = (int*)malloc(sizeof(int) * cells);
+    state->dirty = (int*)malloc(sizeof(int) * cells);
+    state->dirty_mark = (char*)calloc(cells, 1);
+    state->dirty_cnt = (int*)calloc(node_cnt + 1, sizeof(int));
+    state->queue = (int*)malloc(sizeof(int) * (node_cnt + 1));
+    state->queued = (char*)calloc(node_cnt + 1, 1);
+    state->stack = (int*)malloc(sizeof(int) * (node_cnt + 1));
+    state->affected = (char*)calloc(node_cnt + 1, 1);
+    state->queue_head = 0;
+    state->queue_cnt = 0;
+
+    for (size_t i = 0; i < (size_t)node_cnt * node_cnt; i++) {
+        state->dist[i] = ROUTE_INFINITY;
+        state->next[i] = -1;
+    }
+    for (int x = 0; x < node_cnt; x++) {
+        state->dist[(size_t)x * node_cnt + x] = 0;
+        state->next[(size_t)x * node_cnt + x] = x;
+        dv_mark_dirty(state, x, x);
+    }
+}
+
+void dv_state_free(DvState* state) {
+    graph_free(&state->graph);
+    free(state->dist);
+    free(state->next);
+    free(state->dirty);
+    free(state->dirty_mark);
+    free(state->dirty_cnt);
+    free(state->queue);
+    free(state->queued);
+    free(state->stack);
+    free(state->affected);
+}
+
+// 라우터 x의 목적지 d 경로가 바뀌었음을 기록하고 x를 큐에 넣음
+void dv_mark_dirty(DvState* state, int x, int d) {
+    size_t cell = (size_t)x * state->node_cnt + d;
+    if (!state->dirty_mark[cell]) {
+        state->dirty_mark[cell] = 1;
+        state->dirty[(size_t)x * state->node_cnt + state->dirty_cnt[x]++] = d;
+    }
+    if (!state->queued[x]) {
+        state->queued[x] = 1;
+        state->queue[(state->queue_head + state->queue_cnt++) % state->node_cnt] = x;
+    }
+}
+
+// 큐가 빌 때까지 바뀐 경로만 이웃에게 알림 (RIP의 triggered update)
+void dv_converge(DvState* state) {
+    const Graph* graph = &state->graph;
+    int node_cnt = state->node_cnt;
+    long long updates = 0, relaxed = 0;
+
+    while (state->queue_cnt > 0) {
+        int u = state->queue[state->queue_head];
+        state->queue_head = (state->queue_head + 1) % node_cnt;
+        state->queue_cnt--;
+        state->queued[u] = 0;
+        updates++;
+
+        // u가 알릴 목적지 목록을 꺼냄 (처리 중 u의 행은 바뀌지 않음)
+        int* changed = state->dirty + (size_t)u * node_cnt;
+        int changed_cnt = state->dirty_cnt[u];
+        state->dirty_cnt[u] = 0;
+        for (int i = 0; i < changed_cnt; i++) {
+            state->dirty_mark[(size_t)u * node_cnt + changed[i]] = 0;
+        }
+        const int* u_dist = state->dist + (size_t)u * node_cnt;
+
+        for (int k = graph->offset[u]; k < graph->offset[u] + graph->degree[u]; k++) {
+            int v = graph->adj[k];
+            int cost = graph->weight[k];
+            int* v_dist = state->dist + (size_t)v * node_cnt;
+            int* v_next = state->next + (size_t)v * node_cnt;
+
+            for (int i = 0; i < changed_cnt; i++) {
+                int d = changed[i];
+                int new_distance = route_add(u_dist[d], cost);
+                if (new_distance < ROUTE_INFINITY && new_distance < v_dist[d]) {
+                    v_dist[d] = new_distance;
+                    v_next[d] = u;
+                    dv_mark_dirty(state, v, d);
+                    relaxed++;
+                }
+            }
+        }
+    }
+    STAT_ADD(STAT_UPDATES, updates);
+    STAT_ADD(STAT_RELAXATIONS, relaxed);
+}
+
+// 링크 비용 증가/제거 시: from -> to 링크를 지나 d로 가던 라우터들(다음 홉을 따라가면 from에 닿는 라우터)의
+// 경로를 무효화하고, 영향받지 않은 이웃의 경로로 다시 채움 (무한대까지 세기 방지)
+static void dv_invalidate(DvState* state, int from, int to, int d) {
+    const Graph* graph = &state->graph;
+    int node_cnt = state->node_cnt;
+    if (from == d || state->next[(size_t)from * node_cnt + d] != to) {
+        return;
+    }
+
+    // 다음 홉 트리를 거꾸로 따라가며 영향받는 라우터 수집
+    int top = 0, found = 0;
+    state->stack[top++] = from;
+    state->affected[from] = 1;
+    while (found < top) {
+        int y = state->stack[found++];
+        for (int k = graph->offset[y]; k < graph->offset[y] + graph->degree[y]; k++) {
+            int x = graph->adj[k];
+            if (!state->affected[x] && state->next[(size_t)x * node_cnt + d] == y) {
+                state->affected[x] = 1;
+                state->stack[top++] = x;
+            }
+        }
+    }
+
+    for (int i = 0; i < top; i++) {
+        int x = state->stack[i];
+        state->dist[(size_t)x * node_cnt + d] = ROUTE_INFINITY;
+        state->next[(size_t)x * node_cnt + d] = -1;
+    }
+    for (int i = 0; i < top; i++) {
+        int x = state->stack[i];
+        size_t cell = (size_t)x * node_cnt + d;
+        for (int k = graph->offset[x]; k < graph->offset[x] + graph->degree[x]; k++) {
+            int u = graph->adj[k];
+            int new_distance = route_add(state->dist[(size_t)u * node_cnt + d], graph->weight[k]);
+            if (state->affected[u] || new_distance >= ROUTE_INFINITY) {
+                continue;
+            }
+            if (new_distance < state->dist[cell]) {
+                state->dist[cell] = new_distance;
+                state->next[cell] = u;
+            }
+        }
+        // 무효화된 경로는 다시 채워졌든 아니든 이웃에게 알림
+        dv_mark_dirty(state, x, d);
+    }
+    for (int i = 0; i < top; i++) {
+        state->affected[state->stack[i]] = 0;
+    }
+}
+
+// 변경 사항 하나를 적용하고 영향받는 경로만 작업 목록에 올림 (수렴은 dv_converge에서)
+void dv_apply_change(DvState* state, int source, int destination, int distance) {
+    int old_cost = graph_link_cost(&state->graph, source, destination);
+    if (!graph_apply_change(&state->graph, source, destination, distance)) {
+        return;
+    }
+    int new_cost = graph_link_cost(&state->graph, source, destination);
+    int node_cnt = state->node_cnt;
+
+    if (new_cost > old_cost) {
+        for (int d = 0; d < node_cnt; d++) {
+            dv_invalidate(state, source, destination, d);
+            dv_invalidate(state, destination, source, d);
+        }
+        return;
+    }
+
+    // 비용 감소/링크 추가: 양 끝 라우터가 상대의 모든 경로를 새 비용으로 다시 받음
+    for (int dir = 0; dir < 2; dir++) {
+        int from = dir == 0 ? destination : source;
+        int to = dir == 0 ? source : destination;
+        const int* from_dist = state->dist + (size_t)from * node_cnt;
+        for (int d = 0; d < node_cnt; d++) {
+            size_t cell = (size_t)to * node_cnt + d;
+            int new_distance = route_add(from_dist[d], new_cost);
+            if (new_distance < ROUTE_INFINITY && new_distance < state->dist[cell]) {
+                state->dist[cell] = new_distance;
+                state->next[cell] = from;
+                dv_mark_dirty(state, to, d);
+            }
+        }
+    }
+}
+
+// 작업 목록 엔진의 결과를 라우팅 테이블에 기록
+void dv_store_network(const DvState* state, RouteTable* table) {
+    for (int i = 0; i < state->node_cnt; i++) {
+        size_t row = (size_t)i * state->node_cnt;
+        route_store_row(table, i, state->dist + row, state->next + row);
+    }
+}
+
+// 수렴한 테이블로 상태를 채움 (스냅샷에서 시작) - 알릴 것이 없는 상태가 됨
+void dv_state_seed(DvState* state, const RouteTable* table) {
+    int node_cnt = state->node_cnt;
+    for (int x = 0; x < node_cnt; x++) {
+        for (int d = 0; d < node_cnt; d++) {
+            size_t cell = (size_t)x * node_cnt + d;
+            uint32_t dist = route_get_dist(table, x, d);
+            state->dist[cell] = dist == ROUTE_NONE ? ROUTE_INFINITY : (int)dist;
+            state->next[cell] = dist == ROUTE_NONE ? -1 : (int)route_get_next(table, x, d);
+            state->dirty_mark[cell] = 0;
+        }
+        state->dirty_cnt[x] = 0;
+        state->queued[x] = 0;
+    }
+    state->queue_head = 0;
+    state->queue_cnt = 0;
+}
+
+// 그래프의 링크 정보로 라우팅 테이블 초기화 (initnetwork와 같은 초기 상태)
+void load_network(const Graph* graph, RouteTable* table) {
+    route_table_reset(table);
+    for (int i = 0; i < graph->node_cnt; i++) {
+        for (int k = graph->offset[i]; k < graph->offset[i] + graph->degree[i]; k++) {
+            route_set(table, i, graph->adj[k], (uint32_t)graph->weight[k], (uint32_t)graph->adj[k]);
+        }
+    }
+}
+
+// 네트워크를 토폴로지 파일로부터 초기화하는 함수
+void initialize_network_from_topology(const Topology* topology, RouteTable* table) {
+    initnetwork(topology, table);
+}
+
+// 변경 사항을 적용하는 함수
+int apply_changes(const ChangeList* changes, RouteTable* table, int change) {
+    return change_network(changes, table, change);
+}
+
+// 네트워크 메모리를 해제하는 함수
+void free_network_memory(RouteTable* table) {
+    route_table_free(table);
+}
+
+// 네트워크 초기화 함수 (테이블 블록은 호출한 쪽이 잡아 둠 - route_table_borrow)
+void initnetwork(const Topology* topology, RouteTable* table) {
+    // 처음 자료형으로 되돌림 (링크 비용을 읽으면서 필요하면 같은 블록 안에서 uint32_t로 넓힘)
+    route_table_rewind(table);
+
+    // 각 노드 초기화 - 자기 자신은 거리 0, 다른 노드는 도달 불가
+    route_table_reset(table);
+
+    // 토폴로지의 링크 정보 반영 (비용이 음수이거나 LINK_NONE 이상이면 링크 없음)
+    for (int i = 0; i < topology->link_cnt; i++) {
+        int src = topology->links[i].src;
+        int dst = topology->links[i].dst;
+        int distance = topology->links[i].cost;
+        if (src == dst) {
+            continue;
+        }
+        if (distance < 0 || distance >= LINK_NONE) {
+            set_infinite_distance(table, src, dst);
+            continue;
+        }
+        route_table_reserve(table, distance);
+        route_set(table, src, dst, (uint32_t)distance, (uint32_t)dst);    // 거리와 다음 홉 설정
+        route_set(table, dst, src, (uint32_t)distance, (uint32_t)src);    // 양방향
+    }
+}
+
+// 모든 노드가 인접 노드의 거리 벡터를 한 번씩 받아 갱신 - 인접 노드마다 행 전체를 SIMD 커널로 갱신
+// adjacent_nodes: 호출한 쪽이 잡아 둔 node_cnt칸 작업 공간 (노드마다 다시 씀)
+template <typename T>
+int change_cnt_rows(RouteTable* table, int* adjacent_nodes) {
+    int node_cnt = table->node_cnt;
+    T* dist = route_dist<T>(table);
+    T* next = route_next<T>(table);
+    const T none = route_infinity<T>();
     int change_cnt = 0;  // 변경된 경로 수
 
     // 각 노드에 대해 반복
     for (int current_node = 0; current_node < node_cnt; current_node++) {
-        int adjacent_count = 0;             // 인접한 노드 수
-        int adjacent_nodes[node_cnt];       // 인접한 노드 목록
+        T* current_dist = dist + (size_t)current_node * node_cnt;
+        T* current_next = next + (size_t)current_node * node_cnt;
+        int adjacent_count = 0;             // 인접한 노드 수 (목록은 adjacent_nodes)
 
         // 인접한 노드 탐색
         for (int i = 0; i < node_cnt; i++) {
             // 인접 노드는 자기 자신이 아니고, 다음 홉이 존재해야 함
-            if ((*network)[current_node][i].next != '-' && (*network)[current_node][i].next != (char)('0' + current_node)) {
+            if (current_next[i] != none && current_next[i] != (T)current_node) {
                 int is_already_added = 0;    // 노드가 이미 추가되었는지 여부
                 // 이미 추가되지 않은 경우에만 추가
                 for (int j = 0; j < adjacent_count; j++) {
-                    if ((int)((*network)[current_node][i].next - '0') == adjacent_nodes[j]) {
+                    if ((int)current_next[i] == adjacent_nodes[j]) {
                         is_already_added = 1;  // 이미 추가됨
                         break;
                     }
                 }
                 if (!is_already_added) {
-                    adjacent_nodes[adjacent_count++] = (*network)[current_node][i].next - '0'; // 인접 노드 추가
+                    adjacent_nodes[adjacent_count++] = (int)current_next[i]; // 인접 노드 추가
                 }
             }
         }
@@ -184,103 +1480,64 @@ int change_cnt_network(Node*** network, int node_cnt) {
         // 현재 노드 업데이트
         for (int i = 0; i < adjacent_count; i++) {
             int adjacent_node = adjacent_nodes[i];   // 현재 인접한 노드
+            const T* adjacent_dist = dist + (size_t)adjacent_node * node_cnt;
+            T link = current_dist[adjacent_node];    // 인접 노드까지의 거리 (이 반복에서는 바뀌지 않음)
+            T hop = current_next[adjacent_node];
 
-            // 목적지 노드에 대해 반복
-            for (int destination = 0; destination < node_cnt; destination++) {
-                // 현재 노드나 인접한 노드와 목적지가 같은 경우 무시
-                if (current_node == destination || adjacent_node == destination) {
-                    continue;
-                }
-
-                // 무한대 거리인 경우에는 업데이트하지 않음
-                if ((*network)[current_node][destination].distance == -999 || (*network)[adjacent_node][destination].distance == -999 || (*network)[current_node][adjacent_node].distance == -999) {
-                    continue;
-                }
-                // 새로운 경로가 더 짧으면 업데이트
-                else if ((*network)[current_node][destination].distance > (*network)[adjacent_node][destination].distance + (*network)[current_node][adjacent_node].distance) {
-                    (*network)[current_node][destination].distance = (*network)[adjacent_node][destination].distance + (*network)[current_node][adjacent_node].distance;
-                    (*network)[current_node][destination].next = (*network)[current_node][adjacent_node].next; // 다음 홉 업데이트
-                    change_cnt++;   // 변경된 경로 수 증가
-                }
-            }
+            // 모든 목적지에 대해 인접 노드를 거치는 경로가 더 짧으면 업데이트 (무한대를 더하면 무한대)
+            // 목적지가 현재 노드(거리 0)나 인접 노드(거리 link)인 칸은 더 짧아질 수 없으므로 따로 건너뛰지 않음
+            change_cnt += relax_row(current_dist, current_next, adjacent_dist, link, hop, node_cnt);
         }
     }
 
     return change_cnt;  // 변경된 경로 수 반환
 }
 
-void sender_to_reciever(FILE* outputfile, FILE* messagesfile, Node** network) {
-    int sender, receiver;                       // 송신자와 수신자
-    char message[MAXLINE];                      // 메시지 버퍼
-    rewind(messagesfile);                       // 메시지 파일 포인터를 시작으로 이동
-
-    for (;;) {
-        // 송신자와 수신자 정보를 읽음
-        if (fscanf(messagesfile, "%d %d ", &sender, &receiver) != 2) {
-            break; // 파일 끝에 도달하면 종료
-        }
-        fgets(message, MAXLINE, messagesfile);  // 메시지 읽음
-        fprintf(outputfile, "from %d to %d cost ", sender, receiver); // 출력 파일에 송신자와 수신자 정보 기록
-
-        // 목적지까지의 거리가 유효한 경우
-        if (network[sender][receiver].distance != 999) {
-            fprintf(outputfile, "%d hops ", network[sender][receiver].distance); // 목적지까지의 홉 수 출력
-
-            // 경로를 따라 송신자부터 수신자까지의 노드를 출력
-            while (1) {
-                fprintf(outputfile, "%d ", sender); // 현재 노드 출력
-                // 다음 노드가 목적지라면 반복 종료
-                if (receiver == ((int)(network[sender][receiver].next) - '0')) {
-                    break;
-                }
-                sender = (int)(network[sender][receiver].next) - '0'; // 다음 노드로 이동
-            }
-        } else {
-            fprintf(outputfile, "infinite hops unreachable "); // 목적지에 도달할 수 없는 경우 메시지 출력
-        }
-        fprintf(outputfile, "message %s", message); // 메시지 출력
-    }
-    fprintf(outputfile, "\n"); // 파일 끝에 개행 문자 추가
+// 테이블 자료형(uint16_t / uint32_t)에 맞는 버전 실행
+int change_cnt_network(RouteTable* table, int* adjacent_nodes) {
+    int change_cnt = table->compact ? change_cnt_rows<uint16_t>(table, adjacent_nodes) : change_cnt_rows<uint32_t>(table, adjacent_nodes);
+    STAT_ADD(STAT_SWEEPS, 1);
+    STAT_ADD(STAT_RELAXATIONS, change_cnt);
+    return change_cnt;
 }
 
 // 두 노드 사이의 거리를 무한대로 설정하는 함수
-void set_infinite_distance(Node*** network, int node_1, int node_2) {
-    (*network)[node_1][node_2].distance = 999;
-    (*network)[node_1][node_2].next = '-';
-    (*network)[node_2][node_1].distance = 999;
-    (*network)[node_2][node_1].next = '-';
+void set_infinite_distance(RouteTable* table, int node_1, int node_2) {
+    route_set(table, node_1, node_2, ROUTE_NONE, ROUTE_NONE);
+    route_set(table, node_2, node_1, ROUTE_NONE, ROUTE_NONE);
 }
 
 // 네트워크 변경 및 거리 업데이트 함수
-int change_network(FILE* changesfile, Node*** network, int node_cnt, int change) {
-    int source, destination, distance;
+int change_network(const ChangeList* changes, RouteTable* table, int change) {
+    int node_cnt = table->node_cnt;
 
-    rewind(changesfile);
+    if (change > changes->change_cnt) {
+        return -1; // 변경 사항을 모두 적용했으면 -1 반환
+    }
     for (int i = 0; i < change; i++) {
-        if (fscanf(changesfile, "%d %d %d\n", &source, &destination, &distance) == 3) {
-            if (distance == -999) {
-                // 노드 간의 거리를 무한대로 설정하고 다음 홉을 '-'로 지정
-                set_infinite_distance(network, source, destination);
-            } else if ((*network)[source][destination].distance > distance) {
-                // 새로운 거리가 현재 거리보다 짧은 경우 거리를 업데이트
-                (*network)[source][destination].distance = distance;
-                (*network)[source][destination].next = (char)('0' + destination);
-                (*network)[destination][source].distance = distance;
-                (*network)[destination][source].next = (char)('0' + source);
-            }
-        } else {
-            return -1; // 파일 읽기 오류 발생 시 -1 반환
+        int source = changes->changes[i].src;
+        int destination = changes->changes[i].dst;
+        int distance = changes->changes[i].cost;
+        uint32_t current = route_get_dist(table, source, destination);
+        if (distance == LINK_DOWN) {
+            // 노드 간의 거리를 무한대로 설정하고 다음 홉을 없앰
+            set_infinite_distance(table, source, destination);
+        } else if (distance >= 0 && distance < LINK_NONE && (current == ROUTE_NONE || current > (uint32_t)distance)) {
+            // 새로운 거리가 현재 거리보다 짧은 경우 거리를 업데이트 (링크가 없으면 LINK_NONE보다 짧아야 함)
+            route_table_reserve(table, distance);
+            route_set(table, source, destination, (uint32_t)distance, (uint32_t)destination);
+            route_set(table, destination, source, (uint32_t)distance, (uint32_t)source);
         }
     }
 
     // 노드 간의 경로를 확인하고 특정 조건에 따라 거리를 무한대로 설정
     for (int i = 0; i < node_cnt; i++) {
         for (int j = 0; j < node_cnt; j++) {
-            if (((*network)[i][j].destination - '0') == 1 && ((*network)[i][j].next - '0') == 2) {
-                set_infinite_distance(network, i, j);
+            if (j == 1 && route_get_next(table, i, j) == 2) {
+                set_infinite_distance(table, i, j);
             }
-            if (((*network)[i][j].destination - '0') == 2 && ((*network)[i][j].next - '0') == 1) {
-                set_infinite_distance(network, i, j);
+            if (j == 2 && route_get_next(table, i, j) == 1) {
+                set_infinite_distance(table, i, j);
             }
         }
     }
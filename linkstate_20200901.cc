@@ -1,37 +1,313 @@
 #include <stdio.h>
 #include <stdlib.h>
-#define MAXLINE 1000
-
-typedef struct Node_ {
-    char destination;
-    int distance;
-    char next;
-} Node;
-
-void init_network(FILE* topology, Node*** network, int node_cnt);
-void update_shortest_paths(Node** network, int start, int current, bool* visited, int node_cnt);
-void run_dijkstra(Node**network, int node_cnt);
-int smallest_index(Node* network_, bool* visited, int node_cnt);
-void sender_to_reciever(FILE* outputfile, FILE* messagesfile, Node** network);
-void set_infinite_distance(Node*** network, int node_1, int node_2);
-int change_network(FILE* changesfile, Node*** network, int node_cnt, int change);
-void net_print(FILE* outputfile, Node** network, int node_cnt);
+#include <string.h>
+#include "routing_input.h"
+#include "routing_graph.h"
+#include "routing_table.h"
+#include "routing_heap.h"
+#include "routing_stream.h"
+#include "routing_pool.h"
+#include "routing_fw.h"
+#include "routing_output.h"
+#include "routing_message.h"
+#include "routing_timer.h"
+#include "routing_stats.h"
+#include "routing_daemon.h"
+#include "routing_snapshot.h"
+#include "routing_batch.h"
+#include "routing_scenario.h"
+#include "routing_ch.h"
+#include "routing_arena.h"
+
+#define ENGINE_DENSE 0      // 인접 행렬 + 선형 탐색 (기존 방식)
+#define ENGINE_SPARSE 1     // CSR 인접 구조 + 힙 Dijkstra
+#define ENGINE_DYNAMIC 2    // 변경된 링크의 영향을 받는 최단 경로 트리만 부분 재계산
+#define ENGINE_FW 3         // 타일 단위 Floyd-Warshall (밀집 토폴로지용 all-pairs)
+#define ENGINE_LAZY 4       // 메시지에 필요한 출발점의 트리만 계산해 LRU 캐시에 보관
+#define ENGINE_CH 5         // 축약 계층으로 메시지의 (송신자, 수신자) 경로만 질의
+
+#define LAZY_DEFAULT_MB 256 // lazy 엔진 캐시의 기본 메모리 한도
+
+static const char* const engine_names[] = {"dense", "sparse", "dynamic", "fw", "lazy", "ch"};
+
+// 실행 옵션
+typedef struct Options_ {
+    int engine;
+    int stream;     // 상태를 유지하며 변경 사항을 한 번씩만 적용 (-s)
+    int follow;     // 변경 파일 끝에서 새 줄을 기다림 (-f)
+    int threads;    // 출발점별 계산에 사용할 스레드 수 (-j)
+    int print;      // lazy / ch 엔진에서도 전체 라우팅 테이블 출력 (-p)
+    long long cache_bytes;  // lazy 엔진 캐시의 메모리 한도 (-m MB)
+    int delta;      // 라우팅 테이블은 지난번과 달라진 칸만 출력 (-d)
+    BatchOptions batch; // 변경 사항 묶기 (-b N, -w MS)
+    const char* daemon;     // 데몬 모드의 Unix 소켓 경로 (-D)
+    const char* what_if;    // 고장 시나리오 파일, links 또는 nodes (--what-if)
+    const char* save_snapshot;  // 계산한 테이블을 쓸 스냅샷 파일 (--save-snapshot)
+    const char* load_snapshot;  // 처음 계산 대신 읽을 스냅샷 파일 (--load-snapshot)
+} Options;
+
+// 희소 엔진의 작업 공간 - 출발점마다 다시 할당하지 않고 재사용
+typedef struct SpfScratch_ {
+    Heap heap;
+    int* dist;      // 출발점으로부터의 거리
+    int* next;      // 첫 번째 홉 (-1이면 도달 불가)
+    int* best;      // 출발점보다 번호가 작은 최단 경로 조상 중 가장 먼저 방문되는 노드
+    int* order;     // 힙에서 꺼낸 순서 (부분 재계산에서는 영향 영역 목록)
+    char* in_region; // 부분 재계산 영역 표시
+    int* rank;      // 비용 0인 링크가 있을 때 run_dijkstra의 방문 순서
+    int* group;     // 비용 0인 링크로 이어진 같은 거리 노드 묶음 (level 안의 시작 위치)
+    int* level;     // 같은 거리 노드들을 묶음끼리 모아 둔 목록
+} SpfScratch;
+
+// 동적 SPF 상태 - 모든 출발점의 거리/다음 홉/best를 N x N 배열로 유지
+typedef struct SpfState_ {
+    Graph graph;
+    int node_cnt;
+    int* dist;
+    int* next;
+    int* best;
+    WorkerPool* pool;
+    SpfScratch* scratch;    // 스레드별 작업 공간
+} SpfState;
+
+// 스레드 풀에 넘기는 작업 정보
+typedef struct SparseJob_ {
+    const Graph* graph;
+    RouteTable* table;
+    SpfScratch* scratch;    // 스레드별 작업 공간
+} SparseJob;
+
+// 고장 시나리오 작업 공간 (스레드별) - 기본 그래프의 사본에서 고장 난 링크를 빼고 계산한 뒤 되돌려 놓음
+// 경로는 copy-on-write: 출발점의 행은 기본 경로를 같이 읽다가, 고장 난 링크가 그 행의 최단 경로에 쓰였을 때만
+// 자기 행으로 복사해서 영향 영역만 고침 (spf_repair_row)
+typedef struct WhatIfWorker_ {
+    Graph graph;
+    SpfScratch scratch;
+    Link* removed;          // 이번 시나리오에서 뺀 링크 (되돌릴 때 사용)
+    int removed_cnt;
+    int removed_cap;
+    char* failed;           // 고장 난 노드 표시
+    int* row_of;            // 출발점별 복사한 행 번호 (-1이면 기본 경로를 읽음)
+    int* owner;             // 복사한 행의 출발점
+    int* rows;              // 복사한 행들 - 행마다 dist, next, best (3 * node_cnt)
+    int row_cnt;
+    int row_cap;
+} WhatIfWorker;
+
+// 고장 시나리오 평가 - 기본 경로(dist, next, best)는 모든 스레드가 같이 읽음
+typedef struct WhatIfJob_ {
+    const Graph* graph;
+    int* dist;              // 기본 경로 dist[start * node_cnt + d]
+    int* next;
+    int* best;
+    const ScenarioList* list;
+    ScenarioResult* results;
+    WhatIfWorker* workers;
+} WhatIfJob;
+
+typedef struct RepairJob_ {
+    SpfState* state;
+    int node_1, node_2;
+    int old_cost, new_cost;
+} RepairJob;
+
+// lazy 엔진의 트리 캐시 - 슬롯마다 출발점 하나의 거리/다음 홉 배열을 두고 LRU 순서로 내보냄
+typedef struct LazyCache_ {
+    const Graph* graph;
+    int node_cnt;
+    int capacity;       // 보관할 수 있는 트리 수 (메모리 한도 / 트리 크기)
+    int used;
+    int* slot_of;       // 출발점 -> 슬롯 (-1이면 캐시에 없음)
+    int* source;        // 슬롯 -> 출발점
+    int* newer;         // LRU 이중 연결 리스트 (head가 가장 최근에 사용한 슬롯)
+    int* older;
+    int head;
+    int tail;
+    int* dist;          // 슬롯 s의 거리: dist[s * node_cnt ...]
+    int* next;
+    SpfScratch scratch;
+} LazyCache;
+
+// 스트림 모드와 데몬 모드의 엔진 - 그래프(동적 엔진은 SPF 상태)를 유지하며 변경 사항을 적용하고 테이블을 계산
+typedef struct StreamEngine_ {
+    const Options* opts;
+    const Topology* topology;
+    SpfState state;     // 동적 엔진
+    Graph loaded;       // 그 외 엔진
+    Graph* graph;
+    WorkerPool* pool;
+    Arena arena;        // dense 엔진의 visited (처음에 한 번 잡음)
+    bool* visited;
+} StreamEngine;
+
+void parse_options(int* argc, char** argv, Options* opts);
+void load_network(const Graph* graph, RouteTable* table);
+void init_network(const Topology* topology, RouteTable* table);
+template <typename T> int update_shortest_paths(RouteTable* table, int start, int current, bool* visited);
+template <typename T> void dijkstra_rows(RouteTable* table, bool* visited);
+void run_dijkstra(RouteTable* table, bool* visited);
+template <typename T> int smallest_index(const T* row, bool* visited, int node_cnt);
+void set_infinite_distance(RouteTable* table, int node_1, int node_2);
+int change_network(const ChangeList* changes, RouteTable* table, int change);
+void net_print(OutBuf* out, const RouteTable* table);
+void spf_scratch_init(SpfScratch* scratch, int node_cnt);
+void spf_scratch_free(SpfScratch* scratch);
+void sparse_shortest_paths(const Graph* graph, int start, int* dist, int* next, int* best, SpfScratch* scratch);
+void resolve_next_hop(const Graph* graph, int start, int node, const int* dist, int* next, int* best);
+void sparse_job_init(SparseJob* job, int thread_cnt, int node_cnt);
+void sparse_job_free(SparseJob* job, int thread_cnt);
+void sparse_job_run(SparseJob* job, const Graph* graph, RouteTable* table, WorkerPool* pool);
+void run_sparse_dijkstra(const Graph* graph, RouteTable* table, WorkerPool* pool);
+void run_sparse_engine(const Options* opts, const Topology* topology, MessageBatch* messages, const ChangeList* changes, OutBuf* out, WorkerPool* pool, const RouteSnapshot* snapshot);
+void spf_state_init(SpfState* state, const Topology* topology, WorkerPool* pool, const RouteSnapshot* snapshot);
+void spf_state_free(SpfState* state);
+void spf_repair_row(const Graph* graph, SpfScratch* scratch, int start, int* dist, int* next, int* best, int node_1, int node_2, int old_cost, int new_cost);
+void spf_repair_source(SpfState* state, SpfScratch* scratch, int start, int node_1, int node_2, int old_cost, int new_cost);
+void spf_apply_change(SpfState* state, int source, int destination, int distance);
+void run_dense_engine(const Options* opts, const Topology* topology, MessageBatch* messages, const ChangeList* changes, OutBuf* out, const RouteSnapshot* snapshot);
+void stream_engine_init(StreamEngine* engine, const Options* opts, const Topology* topology, WorkerPool* pool, const RouteSnapshot* snapshot);
+void stream_engine_free(StreamEngine* engine);
+void stream_engine_apply(void* ctx, int source, int destination, int distance);
+void stream_engine_compute(void* ctx, int change, RouteTable* table);
+void run_daemon(const Options* opts, int argc, char** argv);
+void what_if_fail_link(const WhatIfJob* job, WhatIfWorker* worker, int u, int v);
+void run_what_if(const Options* opts, int argc, char** argv);
+void stream_engine_save(void* ctx, const Link* changes, int change_cnt, const RouteTable* table);
+const RouteSnapshot* open_snapshot(const Options* opts, const Topology* topology, RouteSnapshot* snapshot, int with_changes);
+void save_snapshot(const Options* opts, const Topology* topology, const Link* changes, int change_cnt, const RouteTable* table, const int* aux);
+void run_stream_engine(const Options* opts, const Topology* topology, MessageBatch* messages, FILE* changesfile, const ChangeList* changes, OutBuf* out, WorkerPool* pool, const RouteSnapshot* snapshot);
+int spf_tree_affected(const int* dist, int node_1, int node_2, int old_cost, int new_cost);
+void lazy_cache_init(LazyCache* cache, const Graph* graph, long long cache_bytes);
+void lazy_cache_free(LazyCache* cache);
+int lazy_cache_tree(LazyCache* cache, int start);
+void lazy_apply_change(LazyCache* cache, Graph* graph, int source, int destination, int distance);
+RouteView lazy_route_view(LazyCache* cache);
+void run_lazy_engine(const Options* opts, const Topology* topology, MessageBatch* messages, FILE* changesfile, const ChangeList* changes, OutBuf* out);
+void run_ch_engine(const Options* opts, const Topology* topology, MessageBatch* messages, FILE* changesfile, const ChangeList* changes, OutBuf* out);
+
+// 옵션(-e dense|sparse|dynamic|fw|lazy|ch, -s, -f, -j N, -p, -m MB, -b N, -w MS, -d, -t, -c 파일, -D 소켓, --what-if 시나리오, --save-snapshot / --load-snapshot 파일)을 읽고 나머지 인자만 argv 앞쪽에 남김
+void parse_options(int* argc, char** argv, Options* opts) {
+    int positional = 1;
+    opts->engine = ENGINE_DENSE;
+    opts->stream = 0;
+    opts->follow = 0;
+    opts->threads = 1;
+    opts->print = 0;
+    opts->cache_bytes = (long long)LAZY_DEFAULT_MB << 20;
+    opts->delta = 0;
+    opts->batch.size = 0;
+    opts->batch.window = 0;
+    opts->daemon = NULL;
+    opts->what_if = NULL;
+    opts->save_snapshot = NULL;
+    opts->load_snapshot = NULL;
+    const char* stats_path = NULL;
+
+    for (int i = 1; i < *argc; i++) {
+        if (strcmp(argv[i], "-e") == 0 && i + 1 < *argc) {
+            i++;
+            if (strcmp(argv[i], "dense") == 0) {
+                opts->engine = ENGINE_DENSE;
+            } else if (strcmp(argv[i], "sparse") == 0) {
+                opts->engine = ENGINE_SPARSE;
+            } else if (strcmp(argv[i], "dynamic") == 0) {
+                opts->engine = ENGINE_DYNAMIC;
+            } else if (strcmp(argv[i], "fw") == 0) {
+                opts->engine = ENGINE_FW;
+            } else if (strcmp(argv[i], "lazy") == 0) {
+                opts->engine = ENGINE_LAZY;
+            } else if (strcmp(argv[i], "ch") == 0) {
+                opts->engine = ENGINE_CH;
+            } else {
+                printf("Error: unknown engine %s\n", argv[i]);
+                exit(0);
+            }
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < *argc) {
+            opts->threads = atoi(argv[++i]);
+            if (opts->threads < 1) {
+                printf("Error: invalid thread count %s\n", argv[i]);
+                exit(0);
+            }
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < *argc) {
+            long long megabytes = atoll(argv[++i]);
+            if (megabytes < 1) {
+                printf("Error: invalid cache size %s\n", argv[i]);
+                exit(0);
+            }
+            opts->cache_bytes = megabytes << 20;
+        } else if (strcmp(argv[i], "-d") == 0) {
+            opts->delta = 1;
+        } else if (strcmp(argv[i], "-t") == 0) {
+            phase_timer.enabled = 1;
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < *argc) {
+            stats_path = argv[++i];
+        } else if (strcmp(argv[i], "-D") == 0 && i + 1 < *argc) {
+            opts->daemon = argv[++i];
+        } else if (strcmp(argv[i], "--what-if") == 0 && i + 1 < *argc) {
+            opts->what_if = argv[++i];
+        } else if (strcmp(argv[i], "--save-snapshot") == 0 && i + 1 < *argc) {
+            opts->save_snapshot = argv[++i];
+        } else if (strcmp(argv[i], "--load-snapshot") == 0 && i + 1 < *argc) {
+            opts->load_snapshot = argv[++i];
+        } else if (strcmp(argv[i], "-p") == 0) {
+            opts->print = 1;
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < *argc) {
+            opts->batch.size = atoi(argv[++i]);
+            if (opts->batch.size < 1) {
+                printf("Error: invalid batch size %s\n", argv[i]);
+                exit(0);
+            }
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < *argc) {
+            opts->batch.window = atoll(argv[++i]);
+            if (opts->batch.window < 1) {
+                printf("Error: invalid batch window %s\n", argv[i]);
+                exit(0);
+            }
+        } else if (strcmp(argv[i], "-s") == 0) {
+            opts->stream = 1;
+        } else if (strcmp(argv[i], "-f") == 0) {
+            opts->stream = 1;
+            opts->follow = 1;
+        } else {
+            argv[positional++] = argv[i];
+        }
+    }
+    *argc = positional;
+    if (stats_path) {
+        stats_enable(stats_path, "linkstate", engine_names[opts->engine]);
+    }
+    if ((opts->save_snapshot || opts->load_snapshot) && (opts->engine == ENGINE_LAZY || opts->engine == ENGINE_CH)) {
+        printf("Error: the %s engine does not keep full tables for snapshots\n", engine_names[opts->engine]);
+        exit(0);
+    }
+
+    // 변경 사항을 stdin("-")으로 받으면 되감을 수 없으므로 스트림 모드
+    if (positional == 4 && strcmp(argv[3], "-") == 0) {
+        opts->stream = 1;
+    }
+    // 변경 사항을 묶으면 묶음마다 상태를 이어서 계산하므로 스트림 모드
+    if (batch_enabled(&opts->batch)) {
+        opts->stream = 1;
+    }
+}
 
 // 파일 열기 및 오류 처리
-void open_files(FILE** topology, FILE** messagesfile, FILE** changesfile, FILE** outputfile, int argc, char** argv) {
+void open_files(FILE** topologyfile, FILE** messagesfile, FILE** changesfile, FILE** outputfile, int argc, char** argv) {
     if (argc != 4) {
-        printf("usage: linkstate topologyfile messagesfile changesfile\n");
+        printf("usage: linkstate [-e dense|sparse|dynamic|fw|lazy|ch] [-s] [-f] [-j threads] [-p] [-m MB] [-b changes] [-w ms] [-d] [-t] [-c statsfile] [--save-snapshot file] [--load-snapshot file] topologyfile messagesfile changesfile|-\n");
+        printf("       linkstate -D socket [-e dense|sparse|dynamic|fw] [-j threads] [--save-snapshot file] [--load-snapshot file] topologyfile\n");
+        printf("       linkstate --what-if links|nodes|scenariofile [-j threads] topologyfile\n");
         exit(0);
     }
 
-    *topology = fopen(argv[1], "r");
+    *topologyfile = fopen(argv[1], "r");
     *messagesfile = fopen(argv[2], "r");
-    *changesfile = fopen(argv[3], "r");
+    *changesfile = open_changes_file(argv[3]);
     *outputfile = fopen("output_ls.txt", "w");
 
-    if (!*topology || !*messagesfile || !*changesfile || !*outputfile) {
+    if (!*topologyfile || !*messagesfile || !*changesfile || !*outputfile) {
         printf("Error: open input file\n");
-        if (*topology) fclose(*topology);
+        if (*topologyfile) fclose(*topologyfile);
         if (*messagesfile) fclose(*messagesfile);
         if (*changesfile) fclose(*changesfile);
         if (*outputfile) fclose(*outputfile);
@@ -40,143 +316,253 @@ void open_files(FILE** topology, FILE** messagesfile, FILE** changesfile, FILE**
 }
 
 // 파일 닫기
-void close_files(FILE* topology, FILE* messagesfile, FILE* changesfile, FILE* outputfile) {
+void close_files(FILE* topologyfile, FILE* messagesfile, FILE* changesfile, FILE* outputfile) {
     fclose(outputfile);
     fclose(changesfile);
     fclose(messagesfile);
-    fclose(topology);
+    fclose(topologyfile);
 }
 
-void net_print(FILE* outputfile, Node** network, int node_cnt) {
-    for (int i = 0; i < node_cnt; i++) {
-        for (int j = 0; j < node_cnt; j++) {
-            // 거리가 유효한 경우에만 출력
-            if (network[i][j].distance != 999) {
-                fprintf(outputfile, "%c %c %d\n", network[i][j].destination, network[i][j].next, network[i][j].distance);
-            }
-        }
-        fprintf(outputfile, "\n"); // 각 행의 끝에 개행 문자 출력
-    }
+void net_print(OutBuf* out, const RouteTable* table) {
+    out_route_table(out, table); // 거리가 유효한 칸만, 라우터마다 빈 줄로 끝남
 }
 
 int main(int argc, char **argv) {
-    FILE *topology, *messagesfile, *changesfile, *outputfile;
-    Node** network;
-    int node_cnt;
-    int change = 0;
+    FILE *topologyfile, *messagesfile, *changesfile, *outputfile;
+    Topology topology;
+    ChangeList changes = {NULL, 0};
+    MessageBatch messages;
+    OutBuf out;
+    Options opts;
 
-    open_files(&topology, &messagesfile, &changesfile, &outputfile, argc, argv);
+    parse_options(&argc, argv, &opts);
+    if (opts.daemon) {
+        run_daemon(&opts, argc, argv);
+        return 0;
+    }
+    if (opts.what_if) {
+        run_what_if(&opts, argc, argv);
+        return 0;
+    }
+    open_files(&topologyfile, &messagesfile, &changesfile, &outputfile, argc, argv);
 
-    while (1) {
-        rewind(topology);
-        fscanf(topology, "%d\n", &node_cnt);
-        init_network(topology, &network, node_cnt);
-        if (change != 0) {
-            if (change_network(changesfile, &network, node_cnt, change) != 0) {
-                break;
-            }
-        }
-        run_dijkstra(network, node_cnt);
-        net_print(outputfile, network, node_cnt);
-        sender_to_reciever(outputfile, messagesfile, network);
-        change++;
+    // 입력은 한 번만 읽어 둠 (변경 사항은 stdin이나 follow 모드면 스트림에서 한 줄씩)
+    int follow_changes = opts.follow || changesfile == stdin;
+    timer_start();
+    int loaded = topology_load(&topology, topologyfile) == 0;
+    if (loaded && !follow_changes) {
+        loaded = changes_load(&changes, changesfile, topology.node_cnt, batch_enabled(&opts.batch)) == 0;
+    }
+    if (loaded && message_batch_load(&messages, messagesfile, topology.node_cnt) != 0) {
+        message_batch_free(&messages);
+        loaded = 0;
+    }
+    timer_add(&phase_timer.parse);
+    stats_start(loaded ? topology.node_cnt : 0);
+    if (!loaded) {
+        changes_free(&changes);
+        topology_free(&topology);
+        close_files(topologyfile, messagesfile, changesfile, outputfile);
+        exit(0);
     }
+    const ChangeList* change_list = follow_changes ? NULL : &changes;
 
-    printf("Complete. Output file written to output_ls.txt.\n");
+    // 처음 상태(변경 사항 0번)는 맞는 스냅샷이 있으면 계산하지 않고 가져옴
+    RouteSnapshot snapshot;
+    const RouteSnapshot* initial = open_snapshot(&opts, &topology, &snapshot, 0);
 
-    for (int i = 0; i < node_cnt; i++) {
-        free(network[i]);
+    // 출력은 버퍼에 모아서 기록
+    out_init(&out, outputfile, opts.delta);
+
+    if (opts.engine == ENGINE_LAZY) {
+        // lazy 엔진은 메시지를 보내는 라우터의 트리만 그때그때 계산 (한 스레드, 항상 스트림 모드)
+        run_lazy_engine(&opts, &topology, &messages, changesfile, change_list, &out);
+    } else if (opts.engine == ENGINE_CH) {
+        // ch 엔진은 처음에 계층을 한 번 준비하고 메시지마다 질의 (한 스레드, 항상 스트림 모드)
+        run_ch_engine(&opts, &topology, &messages, changesfile, change_list, &out);
+    } else if (opts.stream || opts.engine != ENGINE_DENSE) {
+        // 동적 엔진과 Floyd-Warshall 엔진은 그래프를 유지하며 스트림 모드로 실행
+        // -j는 dense 외의 엔진에만 적용 (dense는 앞 출발점의 결과 행을 읽으므로 순서대로 실행해야 함)
+        WorkerPool pool;
+        pool_init(&pool, opts.threads);
+        if (opts.stream || opts.engine != ENGINE_SPARSE) {
+            run_stream_engine(&opts, &topology, &messages, changesfile, change_list, &out, &pool, initial);
+        } else {
+            run_sparse_engine(&opts, &topology, &messages, &changes, &out, &pool, initial);
+        }
+        pool_free(&pool);
+    } else {
+        run_dense_engine(&opts, &topology, &messages, &changes, &out, initial);
+    }
+    if (initial) {
+        snapshot_close(&snapshot);
     }
-    free(network);
+    printf("Complete. Output file written to output_ls.txt.\n");
 
-    close_files(topology, messagesfile, changesfile, outputfile);
+    timer_start();
+    out_free(&out);
+    timer_add(&phase_timer.output);
+    timer_report();
+    stats_report();
+    message_batch_free(&messages);
+    changes_free(&changes);
+    topology_free(&topology);
+    close_files(topologyfile, messagesfile, changesfile, outputfile);
 
     return 0;
 }
 
-void init_network(FILE* topology, Node*** network, int node_cnt) {
-    // 네트워크 메모리 할당
-    *network = (Node**)malloc(sizeof(Node*) * node_cnt);
-    for (int i = 0; i < node_cnt; i++) {
-        (*network)[i] = (Node*)malloc(sizeof(Node) * node_cnt);
-    }
+// 기존 방식 - 변경 사항마다 처음 토폴로지에 변경 사항들을 다시 적용하고 인접 행렬 Dijkstra로 계산
+// 테이블(uint32_t 크기)과 visited는 처음에 arena 하나로 잡아 두고 변경 사항마다 같은 자리에 다시 채움
+void run_dense_engine(const Options* opts, const Topology* topology, MessageBatch* messages, const ChangeList* changes, OutBuf* out, const RouteSnapshot* snapshot) {
+    int node_cnt = topology->node_cnt;
+    Arena arena;
+    RouteTable table;
 
-     // 각 노드 초기화
-    for (int i = 0; i < node_cnt; i++) {
-        for (int j = 0; j < node_cnt; j++) {
-            (*network)[i][j].destination = (char)('0' + j); // 목적지 노드 설정
+    arena_init(&arena, arena_bytes(route_table_bytes(node_cnt)) + arena_bytes(sizeof(bool) * node_cnt));
+    route_table_borrow(&table, arena_alloc(&arena, route_table_bytes(node_cnt)), node_cnt);
+    bool* visited = (bool*)arena_alloc(&arena, sizeof(bool) * node_cnt);
 
-            if (i == j) {
-                // 자기 자신인 경우
-                (*network)[i][j].distance = 0;
-                (*network)[i][j].next = (char)('0' + i);
-            } else {
-                // 다른 노드인 경우
-                (*network)[i][j].distance = 999; // 무한대 의미
-                (*network)[i][j].next = '-';     // 연결 없음
+    for (int change = 0; ; change++) {
+        init_network(topology, &table);
+        if (change != 0) {
+            if (change_network(changes, &table, change) != 0) {
+                break;
             }
         }
+        if (change == 0 && snapshot) {
+            route_table_copy(&table, &snapshot->table);
+        } else {
+            run_dijkstra(&table, visited);
+        }
+        if (change == 0) {
+            save_snapshot(opts, topology, NULL, 0, &table, NULL);
+        }
+        timer_event();
+        RouteView view = route_view_table(&table);
+        stats_event(&view);
+        net_print(out, &table);
+        timer_add(&phase_timer.output);
+        message_batch_write(out, messages, &view);
+        timer_add(&phase_timer.trace);
+        stats_event_output(out_total(out));
+    }
+    arena_free(&arena);
+}
+
+// 그래프의 링크 정보로 라우팅 테이블 초기화 (init_network와 같은 초기 상태)
+void load_network(const Graph* graph, RouteTable* table) {
+    route_table_reset(table);
+    for (int i = 0; i < graph->node_cnt; i++) {
+        for (int k = graph->offset[i]; k < graph->offset[i] + graph->degree[i]; k++) {
+            route_set(table, i, graph->adj[k], (uint32_t)graph->weight[k], (uint32_t)graph->adj[k]);
+        }
     }
+}
+
+// 테이블 블록은 호출한 쪽이 잡아 둠 (route_table_borrow)
+void init_network(const Topology* topology, RouteTable* table) {
+    // 처음 자료형으로 되돌림 (링크 비용을 읽으면서 필요하면 같은 블록 안에서 uint32_t로 넓힘)
+    route_table_rewind(table);
+
+    // 각 노드 초기화 - 자기 자신은 거리 0, 다른 노드는 도달 불가
+    route_table_reset(table);
 
-     // 토폴로지 파일에서 네트워크 정보 읽기
-    int src, dst, distance;
-    while (fscanf(topology, "%d %d %d\n", &src, &dst, &distance) != EOF) {
-        (*network)[src][dst].distance = distance;        // 거리 설정
-        (*network)[src][dst].next = (char)('0' + dst);   // 다음 홉 설정
-        (*network)[dst][src].distance = distance;        // 양방향 거리 설정
-        (*network)[dst][src].next = (char)('0' + src);   // 양방향 다음 홉 설정
+    // 토폴로지의 링크 정보 반영 (비용이 음수이거나 LINK_NONE 이상이면 링크 없음)
+    for (int i = 0; i < topology->link_cnt; i++) {
+        int src = topology->links[i].src;
+        int dst = topology->links[i].dst;
+        int distance = topology->links[i].cost;
+        if (src == dst) {
+            continue;
+        }
+        if (distance < 0 || distance >= LINK_NONE) {
+            set_infinite_distance(table, src, dst);
+            continue;
+        }
+        route_table_reserve(table, distance);
+        route_set(table, src, dst, (uint32_t)distance, (uint32_t)dst);    // 거리와 다음 홉 설정
+        route_set(table, dst, src, (uint32_t)distance, (uint32_t)src);    // 양방향
     }
 }
 
 // 선택된 노드를 거쳐 갈 때 더 짧은 경로가 있는지 확인하여 업데이트
-void update_shortest_paths(Node** network, int start, int current, bool* visited, int node_cnt) {
+// start 행과 current 행을 연속된 배열로 훑음, 업데이트한 목적지 수를 반환
+template <typename T>
+int update_shortest_paths(RouteTable* table, int start, int current, bool* visited) {
+    int node_cnt = table->node_cnt;
+    T* start_dist = route_dist<T>(table) + (size_t)start * node_cnt;
+    T* start_next = route_next<T>(table) + (size_t)start * node_cnt;
+    const T* current_dist = route_dist<T>(table) + (size_t)current * node_cnt;
+    T via = start_dist[current];
+    int relaxed = 0;
+
     for (int dest = 0; dest < node_cnt; dest++) {
         // 방문하지 않은 노드에 대해서만 처리
         if (!visited[dest]) {
             // 현재 노드를 거쳐 목적지로 가는 새로운 거리 계산
-            int new_distance = network[start][current].distance + network[current][dest].distance;
+            T new_distance = route_add(via, current_dist[dest]);
             // 새로운 거리가 기존 거리보다 짧으면 업데이트
-            if (new_distance < network[start][dest].distance) {
-                network[start][dest].distance = new_distance;
+            if (new_distance < start_dist[dest]) {
+                start_dist[dest] = new_distance;
                 // 이전 노드를 찾아 업데이트
-                int temp = current;
-                while (network[start][temp].destination != network[start][temp].next) {
-                    temp = (int)(network[start][temp].next - '0');
+                T temp = (T)current;
+                while (start_next[temp] != temp) {
+                    temp = start_next[temp];
                 }
-                network[start][dest].next = (char)('0' + temp);
+                start_next[dest] = temp;
+                relaxed++;
             }
         }
     }
+    return relaxed;
 }
 
-// 시작 노드부터 모든 노드까지의 최단 경로 계산
-void run_dijkstra(Node** network, int node_cnt) {
+// 시작 노드부터 모든 노드까지의 최단 경로 계산 (visited: 호출한 쪽이 잡아 둔 node_cnt칸 작업 공간)
+template <typename T>
+void dijkstra_rows(RouteTable* table, bool* visited) {
+    int node_cnt = table->node_cnt;
+    long long relaxed = 0;
+
     // 모든 노드에 대해 반복
     for (int start = 0; start < node_cnt; start++) {
-        bool visited[node_cnt] = { false }; // 방문한 노드를 기록하는 배열 초기화
+        memset(visited, 0, sizeof(bool) * node_cnt); // 방문한 노드를 기록하는 배열 초기화
         visited[start] = true; // 시작 노드를 방문한 것으로 표시
+        const T* row = route_dist<T>(table) + (size_t)start * node_cnt;
 
         // 현재 노드부터 모든 노드까지의 최단 경로를 계산
         for (int i = 0; i < node_cnt - 1; i++) {
-            int current = smallest_index(network[start], visited, node_cnt); // 현재 노드 선택
+            int current = smallest_index<T>(row, visited, node_cnt); // 현재 노드 선택
             if (current < 0 || current >= node_cnt) continue; // 유효하지 않은 노드인 경우 건너뜀
             visited[current] = true; // 현재 노드를 방문한 것으로 표시
 
             // 최단 경로 업데이트 함수 호출
-            update_shortest_paths(network, start, current, visited, node_cnt);
+            relaxed += update_shortest_paths<T>(table, start, current, visited);
         }
     }
+    STAT_ADD(STAT_MIN_SCANS, node_cnt > 0 ? (long long)node_cnt * (node_cnt - 1) : 0);
+    STAT_ADD(STAT_RELAXATIONS, relaxed);
+}
+
+// 테이블 자료형(uint16_t / uint32_t)에 맞는 버전 실행
+void run_dijkstra(RouteTable* table, bool* visited) {
+    if (table->compact) {
+        dijkstra_rows<uint16_t>(table, visited);
+    } else {
+        dijkstra_rows<uint32_t>(table, visited);
+    }
 }
 
 // 방문하지 않은 노드 중에서 가장 작은 거리를 가진 노드의 인덱스 반환
-int smallest_index(Node* network_, bool* visited, int node_cnt) {
-    int min_distance = 999; // 초기 최소 거리를 무한대로 설정
+template <typename T>
+int smallest_index(const T* row, bool* visited, int node_cnt) {
+    T min_distance = route_infinity<T>(); // 초기 최소 거리를 무한대로 설정
     int smallest_index = -1; // 초기 인덱스를 -1로 설정
 
     // 모든 노드를 확인하여 가장 작은 거리를 가진 노드의 인덱스 찾기
     for (int i = 0; i < node_cnt; i++) {
-        if (network_[i].distance < min_distance && !visited[i]) {
-            min_distance = network_[i].distance;
+        if (row[i] < min_distance && !visited[i]) {
+            min_distance = row[i];
             smallest_index = i;
         }
     }
@@ -184,78 +570,1285 @@ int smallest_index(Node* network_, bool* visited, int node_cnt) {
     return smallest_index;
 }
 
-void sender_to_reciever(FILE* outputfile, FILE* messagesfile, Node** network) {
-    int sender, receiver;                       // 송신자와 수신자
-    char message[MAXLINE];                      // 메시지 버퍼
-    rewind(messagesfile);                       // 메시지 파일 포인터를 시작으로 이동
+void spf_scratch_init(SpfScratch* scratch, int node_cnt) {
+    heap_init(&scratch->heap, node_cnt);
+    scratch->dist = (int*)malloc(sizeof(int) * node_cnt);
+    scratch->next = (int*)malloc(sizeof(int) * node_cnt);
+    scratch->best = (int*)malloc(sizeof(int) * node_cnt);
+    scratch->order = (int*)malloc(sizeof(int) * node_cnt);
+    scratch->in_region = (char*)calloc(node_cnt, 1);
+    scratch->rank = (int*)malloc(sizeof(int) * node_cnt);
+    scratch->group = (int*)malloc(sizeof(int) * node_cnt);
+    scratch->level = (int*)malloc(sizeof(int) * node_cnt);
+    scratch->heap.key = scratch->dist;
+}
+
+void spf_scratch_free(SpfScratch* scratch) {
+    heap_free(&scratch->heap);
+    free(scratch->dist);
+    free(scratch->next);
+    free(scratch->best);
+    free(scratch->order);
+    free(scratch->in_region);
+    free(scratch->rank);
+    free(scratch->group);
+    free(scratch->level);
+}
+
+// run_dijkstra의 방문 순서: 거리가 작은 노드, 거리가 같으면 번호가 작은 노드가 먼저
+static inline int visited_before(const int* dist, int a, int b) {
+    if (a < 0) return 0;
+    if (b < 0) return 1;
+    return dist[a] < dist[b] || (dist[a] == dist[b] && a < b);
+}
+
+// 노드 하나의 다음 홉 결정 - 최단 경로상의 부모들이 먼저 결정되어 있어야 함
+// run_dijkstra는 자신보다 번호가 작은 출발점의 행(이미 계산된 최단 거리)을 거쳐서도 갱신하므로
+// 직접 링크가 최단이면 그 링크를, 아니면 "번호가 작은 조상(best)"과 "번호가 큰 부모" 중
+// 가장 먼저 방문되는 노드의 다음 홉을 물려받아야 같은 결과가 나옴
+void resolve_next_hop(const Graph* graph, int start, int node, const int* dist, int* next, int* best) {
+    int direct = 0;
+    int ancestor = -1;      // 번호가 작은 조상 중 가장 먼저 방문되는 노드
+    int parent = -1;        // 번호가 큰 부모 중 가장 먼저 방문되는 노드
+
+    for (int k = graph->offset[node]; k < graph->offset[node] + graph->degree[node]; k++) {
+        int p = graph->adj[k];
+        if (dist[p] >= ROUTE_INFINITY || route_add(dist[p], graph->weight[k]) != dist[node]) {
+            continue; // 최단 경로상의 부모가 아님
+        }
+        if (p == start) {
+            direct = 1;
+            continue;
+        }
+        if (visited_before(dist, best[p], ancestor)) {
+            ancestor = best[p];
+        }
+        if (p < start) {
+            if (visited_before(dist, p, ancestor)) {
+                ancestor = p;
+            }
+        } else if (visited_before(dist, p, parent)) {
+            parent = p;
+        }
+    }
+
+    best[node] = ancestor;
+    if (direct) {
+        next[node] = node;
+    } else {
+        next[node] = next[visited_before(dist, ancestor, parent) ? ancestor : parent];
+    }
+}
+
+// 비용 0인 링크가 있을 때의 방문 순서 비교 (rank: run_dijkstra에서 방문한 순서)
+static inline int visited_earlier(const int* rank, int a, int b) {
+    if (a < 0) return 0;
+    if (b < 0) return 1;
+    return rank[a] < rank[b];
+}
+
+// 비용 0인 링크가 있을 때 다음 홉 결정 - order는 힙에서 꺼낸 순서 (거리 오름차순, 맨 앞은 출발점)
+// 같은 거리의 노드라도 run_dijkstra는 "그 거리를 이미 알게 된" 노드 중 번호가 작은 노드부터 방문하므로
+// (dist, 번호) 순서가 방문 순서가 아님. 거리가 같은 노드들(level)마다 그 방문 순서를 흉내 내어 rank를 매김
+//   - 아래 거리의 부모가 있거나, 아래 거리에 번호가 작은 조상(그 행은 이미 최단 거리)이 있으면 처음부터 후보
+//   - 노드 y를 방문하면 비용 0인 링크의 이웃이, y가 출발점보다 번호가 작으면 y와 비용 0으로 이어진 묶음 전체가 후보가 됨
+// 비용 0인 링크로 이어진 같은 거리의 노드들은 서로가 최단 경로상의 조상이므로 best는 묶음 전체가 같음
+// 출발점도 거리 0인 묶음에 들어감 - 출발점과 비용 0으로 이어진 번호가 작은 노드는 모든 노드의 조상 (되돌아오는 경로)
+// 다음 홉은 자신보다 먼저 방문된 부모와 best 중 가장 먼저 방문된 노드의 것을 물려받음 (resolve_next_hop과 같은 규칙)
+static void resolve_zero_cost_hops(const Graph* graph, int start, const int* dist, int* next, int* best, SpfScratch* scratch, int order_cnt) {
+    int* order = scratch->order;
+    int* rank = scratch->rank;
+    int* group = scratch->group;
+    int* level = scratch->level;
+    char* pushed = scratch->in_region;
+    Heap* heap = &scratch->heap;    // 같은 거리끼리는 번호 순으로 꺼냄
+
+    // 출발점은 처음부터 방문한 상태 (다시 후보가 되지 않음)
+    rank[start] = 0;
+    next[start] = start;
+    best[start] = -1;
+    pushed[start] = 1;
+    int visit = 1;
+    for (int i = 0, j; i < order_cnt; i = j) {
+        int d = dist[order[i]];
+        for (j = i; j < order_cnt && dist[order[j]] == d; j++) {
+            group[order[j]] = -1;
+        }
 
-    for (;;) {
-        // 송신자와 수신자 정보를 읽음
-        if (fscanf(messagesfile, "%d %d ", &sender, &receiver) != 2) {
-            break; // 파일 끝에 도달하면 종료
+        // 비용 0인 링크로 묶음을 만들고 (level에 묶음끼리 연속으로), 처음부터 후보인 노드를 힙에 넣음
+        int level_cnt = 0;
+        for (int k = i; k < j; k++) {
+            if (group[order[k]] >= 0) {
+                continue;
+            }
+            int begin = level_cnt;
+            int low = -1;       // 아래 거리에 있는 번호가 작은 조상 중 가장 먼저 방문된 노드
+            group[order[k]] = begin;
+            level[level_cnt++] = order[k];
+            for (int q = begin; q < level_cnt; q++) {
+                int x = level[q];
+                int has_parent = 0;
+                for (int a = graph->offset[x]; a < graph->offset[x] + graph->degree[x]; a++) {
+                    int p = graph->adj[a];
+                    if (graph->weight[a] == 0 && group[p] < 0) {
+                        group[p] = begin;
+                        level[level_cnt++] = p;
+                    }
+                    // 출발점은 거리가 같아도 이미 방문했으므로 아래 거리의 부모처럼 취급
+                    if (dist[p] >= ROUTE_INFINITY || route_add(dist[p], graph->weight[a]) != d || (p != start && dist[p] == d)) {
+                        continue;
+                    }
+                    has_parent = 1;
+                    if (visited_earlier(rank, best[p], low)) {
+                        low = best[p];
+                    }
+                    if (p < start && visited_earlier(rank, p, low)) {
+                        low = p;
+                    }
+                }
+                if (has_parent && !pushed[x]) {
+                    pushed[x] = 1;
+                    heap_push(heap, x);
+                }
+            }
+            best[level[begin]] = low;
+            for (int q = begin; q < level_cnt && low >= 0; q++) {
+                if (!pushed[level[q]]) {
+                    pushed[level[q]] = 1;
+                    heap_push(heap, level[q]);
+                }
+            }
         }
-        fgets(message, MAXLINE, messagesfile);  // 메시지 읽음
-        fprintf(outputfile, "from %d to %d cost ", sender, receiver); // 출력 파일에 송신자와 수신자 정보 기록
 
-        // 목적지까지의 거리가 유효한 경우
-        if (network[sender][receiver].distance != 999) {
-            fprintf(outputfile, "%d hops ", network[sender][receiver].distance); // 목적지까지의 홉 수 출력
+        // 방문 순서대로 꺼내며 새 후보 추가 (order[i ~ j - 1]를 방문 순서로 다시 씀)
+        int popped = i == 0 ? 1 : i;
+        while (heap->size > 0) {
+            int y = heap_pop(heap);
+            rank[y] = visit++;
+            order[popped++] = y;
+            if (y < start) {
+                for (int q = group[y]; q < level_cnt && group[level[q]] == group[y]; q++) {
+                    if (!pushed[level[q]]) {
+                        pushed[level[q]] = 1;
+                        heap_push(heap, level[q]);
+                    }
+                }
+                continue;
+            }
+            for (int a = graph->offset[y]; a < graph->offset[y] + graph->degree[y]; a++) {
+                int p = graph->adj[a];
+                if (graph->weight[a] == 0 && !pushed[p]) {
+                    pushed[p] = 1;
+                    heap_push(heap, p);
+                }
+            }
+        }
 
-            // 경로를 따라 송신자부터 수신자까지의 노드를 출력
-            while (1) {
-                fprintf(outputfile, "%d ", sender); // 현재 노드 출력
-                // 다음 노드가 목적지라면 반복 종료
-                if (receiver == ((int)(network[sender][receiver].next) - '0')) {
-                    break;
+        // 묶음의 best: 아래 거리의 조상과, 둘 이상인 묶음이면 묶음 안의 번호가 작은 노드 중 가장 먼저 방문된 노드
+        for (int begin = 0, end; begin < level_cnt; begin = end) {
+            int low = best[level[begin]];
+            for (end = begin + 1; end < level_cnt && group[level[end]] == begin; end++) {
+            }
+            for (int q = begin; q < end && end - begin > 1; q++) {
+                if (level[q] < start && visited_earlier(rank, level[q], low)) {
+                    low = level[q];
                 }
-                sender = (int)(network[sender][receiver].next) - '0'; // 다음 노드로 이동
             }
+            for (int q = begin; q < end; q++) {
+                best[level[q]] = low;
+                pushed[level[q]] = 0;
+            }
+        }
+
+        // 방문 순서대로 다음 홉 결정 (같은 거리의 부모는 자신보다 먼저 방문된 경우만)
+        for (int k = i; k < j; k++) {
+            int x = order[k];
+            if (x == start) {
+                continue;
+            }
+            int direct = 0;
+            int ancestor = visited_earlier(rank, best[x], x) ? best[x] : -1;
+            for (int a = graph->offset[x]; a < graph->offset[x] + graph->degree[x]; a++) {
+                int p = graph->adj[a];
+                if (dist[p] >= ROUTE_INFINITY || route_add(dist[p], graph->weight[a]) != d) {
+                    continue;
+                }
+                if (p == start) {
+                    direct = 1;
+                } else if (visited_earlier(rank, p, x) && visited_earlier(rank, p, ancestor)) {
+                    ancestor = p;
+                }
+            }
+            next[x] = direct ? x : (ancestor >= 0 ? next[ancestor] : -1);
+        }
+    }
+}
+
+// 출발점 하나에 대한 힙 기반 Dijkstra - 결과는 dist, next, best 배열에 기록
+void sparse_shortest_paths(const Graph* graph, int start, int* dist, int* next, int* best, SpfScratch* scratch) {
+    int node_cnt = graph->node_cnt;
+    int order_cnt = 0;
+    int relaxed = 0;
+    int zero = 0;       // 도달한 노드 사이에 비용 0인 링크가 있음
+
+    for (int i = 0; i < node_cnt; i++) {
+        dist[i] = ROUTE_INFINITY;
+        next[i] = -1;
+        best[i] = -1;
+    }
+    dist[start] = 0;
+    scratch->heap.key = dist;
+    heap_push(&scratch->heap, start);
+
+    while (scratch->heap.size > 0) {
+        int current = heap_pop(&scratch->heap);
+        scratch->order[order_cnt++] = current;
+
+        for (int k = graph->offset[current]; k < graph->offset[current] + graph->degree[current]; k++) {
+            int dest = graph->adj[k];
+            int new_distance = route_add(dist[current], graph->weight[k]);
+            zero |= graph->weight[k] == 0;
+            if (new_distance < dist[dest]) {
+                dist[dest] = new_distance;
+                heap_push(&scratch->heap, dest);
+                relaxed++;
+            }
+        }
+    }
+    STAT_ADD(STAT_HEAP_PUSHES, relaxed + 1);
+    STAT_ADD(STAT_HEAP_POPS, order_cnt);
+    STAT_ADD(STAT_RELAXATIONS, relaxed);
+
+    if (zero) {
+        resolve_zero_cost_hops(graph, start, dist, next, best, scratch, order_cnt);
+        return;
+    }
+
+    // 방문 순서대로 다음 홉 결정 (부모가 항상 먼저 처리됨)
+    next[start] = start;
+    for (int i = 1; i < order_cnt; i++) {
+        resolve_next_hop(graph, start, scratch->order[i], dist, next, best);
+    }
+}
+
+// 출발점 하나 계산 (각 출발점은 그래프만 읽고 자기 행에만 기록하므로 스레드 간 충돌 없음)
+static void sparse_source_task(void* ctx, int worker, int start) {
+    SparseJob* job = (SparseJob*)ctx;
+    SpfScratch* scratch = &job->scratch[worker];
+    sparse_shortest_paths(job->graph, start, scratch->dist, scratch->next, scratch->best, scratch);
+    route_store_row(job->table, start, scratch->dist, scratch->next);
+}
+
+// 스레드별 작업 공간 (출발점 사이와 변경 사항 사이에서 재사용)
+void sparse_job_init(SparseJob* job, int thread_cnt, int node_cnt) {
+    job->scratch = (SpfScratch*)malloc(sizeof(SpfScratch) * thread_cnt);
+    for (int i = 0; i < thread_cnt; i++) {
+        spf_scratch_init(&job->scratch[i], node_cnt);
+    }
+}
+
+void sparse_job_free(SparseJob* job, int thread_cnt) {
+    for (int i = 0; i < thread_cnt; i++) {
+        spf_scratch_free(&job->scratch[i]);
+    }
+    free(job->scratch);
+}
+
+// 모든 출발점에 대해 희소 Dijkstra 실행 (job의 작업 공간 사용)
+void sparse_job_run(SparseJob* job, const Graph* graph, RouteTable* table, WorkerPool* pool) {
+    job->graph = graph;
+    job->table = table;
+    pool_run(pool, graph->node_cnt, sparse_source_task, job);
+}
+
+// 작업 공간을 이번 계산에만 잡아서 실행
+void run_sparse_dijkstra(const Graph* graph, RouteTable* table, WorkerPool* pool) {
+    SparseJob job;
+    sparse_job_init(&job, pool->thread_cnt, graph->node_cnt);
+    sparse_job_run(&job, graph, table, pool);
+    sparse_job_free(&job, pool->thread_cnt);
+}
+
+// 희소 엔진으로 변경 사항마다 라우팅 테이블 계산 및 출력
+// 그래프는 한 번 읽어 변경 사항을 하나씩 적용하고, 테이블(uint32_t 크기)은 arena에, 스레드별 작업 공간은 처음에 한 번 잡음
+void run_sparse_engine(const Options* opts, const Topology* topology, MessageBatch* messages, const ChangeList* changes, OutBuf* out, WorkerPool* pool, const RouteSnapshot* snapshot) {
+    int node_cnt = topology->node_cnt;
+    Graph graph;
+    Arena arena;
+    RouteTable table;
+    SparseJob job;
+
+    graph_load(topology, &graph);
+    arena_init(&arena, arena_bytes(route_table_bytes(node_cnt)));
+    route_table_borrow(&table, arena_alloc(&arena, route_table_bytes(node_cnt)), node_cnt);
+    sparse_job_init(&job, pool->thread_cnt, node_cnt);
+
+    for (int change = 0; ; change++) {
+        if (change != 0) {
+            if (change > changes->change_cnt) {
+                break;
+            }
+            const Link* link = &changes->changes[change - 1];
+            graph_apply_change(&graph, link->src, link->dst, link->cost);
+        }
+        route_table_rewind(&table);
+        route_table_reserve(&table, graph_max_weight(&graph));
+        if (change == 0 && snapshot) {
+            route_table_copy(&table, &snapshot->table);
         } else {
-            fprintf(outputfile, "infinite hops unreachable "); // 목적지에 도달할 수 없는 경우 메시지 출력
+            sparse_job_run(&job, &graph, &table, pool);
+        }
+        if (change == 0) {
+            save_snapshot(opts, topology, NULL, 0, &table, NULL);
         }
-        fprintf(outputfile, "message %s", message); // 메시지 출력
+        timer_event();
+        RouteView view = route_view_table(&table);
+        stats_event(&view);
+        net_print(out, &table);
+        timer_add(&phase_timer.output);
+        message_batch_write(out, messages, &view);
+        timer_add(&phase_timer.trace);
+        stats_event_output(out_total(out));
     }
-    fprintf(outputfile, "\n"); // 파일 끝에 개행 문자 추가
+    sparse_job_free(&job, pool->thread_cnt);
+    arena_free(&arena);
+    graph_free(&graph);
 }
 
-// 두 노드 사이의 거리를 무한대로 설정하는 함수
-void set_infinite_distance(Node*** network, int node_1, int node_2) {
-    (*network)[node_1][node_2].distance = 999;
-    (*network)[node_1][node_2].next = '-';
-    (*network)[node_2][node_1].distance = 999;
-    (*network)[node_2][node_1].next = '-';
+static void spf_source_task(void* ctx, int worker, int start) {
+    SpfState* state = (SpfState*)ctx;
+    size_t row = (size_t)start * state->node_cnt;
+    sparse_shortest_paths(&state->graph, start, state->dist + row, state->next + row, state->best + row, &state->scratch[worker]);
 }
 
-// 네트워크 변경 및 거리 업데이트 함수
-int change_network(FILE* changesfile, Node*** network, int node_cnt, int change) {
+// 토폴로지를 한 번 읽고 모든 출발점의 최단 경로 트리를 계산
+// 스냅샷이 있으면 그 변경 사항들을 그래프에만 적용하고 트리는 스냅샷의 거리/다음 홉/best로 채움
+void spf_state_init(SpfState* state, const Topology* topology, WorkerPool* pool, const RouteSnapshot* snapshot) {
+    graph_load(topology, &state->graph);
+    int node_cnt = state->node_cnt = state->graph.node_cnt;
+    size_t cells = (size_t)node_cnt * node_cnt;
+    state->dist = (int*)malloc(sizeof(int) * (cells > 0 ? cells : 1));
+    state->next = (int*)malloc(sizeof(int) * (cells > 0 ? cells : 1));
+    state->best = (int*)malloc(sizeof(int) * (cells > 0 ? cells : 1));
+    state->pool = pool;
+    state->scratch = (SpfScratch*)malloc(sizeof(SpfScratch) * pool->thread_cnt);
+    for (int i = 0; i < pool->thread_cnt; i++) {
+        spf_scratch_init(&state->scratch[i], node_cnt);
+    }
+
+    if (!snapshot) {
+        pool_run(pool, node_cnt, spf_source_task, state);
+        return;
+    }
     int source, destination, distance;
+    for (int k = 0; k < snapshot->header->change_cnt; k++) {
+        snapshot_change(snapshot, k, &source, &destination, &distance);
+        graph_apply_change(&state->graph, source, destination, distance);
+    }
+    for (int i = 0; i < node_cnt; i++) {
+        for (int j = 0; j < node_cnt; j++) {
+            size_t cell = (size_t)i * node_cnt + j;
+            uint32_t dist = route_get_dist(&snapshot->table, i, j);
+            state->dist[cell] = dist == ROUTE_NONE ? ROUTE_INFINITY : (int)dist;
+            state->next[cell] = dist == ROUTE_NONE ? -1 : (int)route_get_next(&snapshot->table, i, j);
+            state->best[cell] = snapshot->aux[cell];
+        }
+    }
+}
 
-    rewind(changesfile);
-    for (int i = 0; i < change; i++) {
-        if (fscanf(changesfile, "%d %d %d\n", &source, &destination, &distance) == 3) {
-            if (distance == -999) {
-                // 노드 간의 거리를 무한대로 설정하고 다음 홉을 '-'로 지정
-                set_infinite_distance(network, source, destination);
-            } else if ((*network)[source][destination].distance > distance) {
-                // 새로운 거리가 현재 거리보다 짧은 경우 거리를 업데이트
-                (*network)[source][destination].distance = distance;
-                (*network)[source][destination].next = (char)('0' + destination);
-                (*network)[destination][source].distance = distance;
-                (*network)[destination][source].next = (char)('0' + source);
+void spf_state_free(SpfState* state) {
+    graph_free(&state->graph);
+    for (int i = 0; i < state->pool->thread_cnt; i++) {
+        spf_scratch_free(&state->scratch[i]);
+    }
+    free(state->scratch);
+    free(state->dist);
+    free(state->next);
+    free(state->best);
+}
+
+// 영역에 노드 추가
+static inline void spf_region_add(SpfScratch* scratch, int* region_cnt, int node) {
+    if (!scratch->in_region[node]) {
+        scratch->in_region[node] = 1;
+        scratch->order[(*region_cnt)++] = node;
+    }
+}
+
+// 영역을 최단 경로 DAG(dist[x] + w == dist[y])의 자손까지 넓힘
+static inline void spf_region_close(const Graph* graph, const int* dist, SpfScratch* scratch, int* region_cnt) {
+    for (int i = 0; i < *region_cnt; i++) {
+        int x = scratch->order[i];
+        if (dist[x] >= ROUTE_INFINITY) {
+            continue;
+        }
+        for (int k = graph->offset[x]; k < graph->offset[x] + graph->degree[x]; k++) {
+            if (route_add(dist[x], graph->weight[k]) == dist[graph->adj[k]]) {
+                spf_region_add(scratch, region_cnt, graph->adj[k]);
+            }
+        }
+    }
+}
+
+// 링크 (node_1, node_2)의 비용이 old_cost에서 new_cost로 바뀌었을 때 출발점 하나의 트리를 복구
+// 비용 증가/링크 제거: 그 링크를 지나는 최단 경로 DAG의 자손만 거리 초기화 후 경계에서 다시 계산
+// 비용 감소/링크 추가: 새 링크로 짧아지거나 같아지는 노드와 그 자손만 다시 계산
+// 두 경우 모두 영향 영역 밖 노드의 거리, 다음 홉, best는 바뀌지 않음
+void spf_repair_source(SpfState* state, SpfScratch* scratch, int start, int node_1, int node_2, int old_cost, int new_cost) {
+    size_t row = (size_t)start * state->node_cnt;
+    spf_repair_row(&state->graph, scratch, start, state->dist + row, state->next + row, state->best + row, node_1, node_2, old_cost, new_cost);
+}
+
+// spf_repair_source의 본체 - graph는 이미 바뀐 상태, dist / next / best는 출발점 start의 한 행
+// 비용 0인 링크가 있거나 이번에 없어졌으면 영향을 받는 행 전체를 다시 계산
+// (같은 거리의 노드 사이 방문 순서가 영역 밖 노드에도 달려 있어 영역만 고칠 수 없음, resolve_zero_cost_hops)
+void spf_repair_row(const Graph* graph, SpfScratch* scratch, int start, int* dist, int* next, int* best, int node_1, int node_2, int old_cost, int new_cost) {
+    int region_cnt = 0;
+    int pushes = 0, pops = 0, relaxed = 0;
+
+    if (graph->zero_cnt > 0 || old_cost == 0) {
+        if (spf_tree_affected(dist, node_1, node_2, old_cost, new_cost)) {
+            sparse_shortest_paths(graph, start, dist, next, best, scratch);
+        }
+        return;
+    }
+    scratch->heap.key = dist;
+
+    if (new_cost > old_cost) {
+        // 기존 트리에서 이 링크가 최단 경로에 쓰였는지 확인
+        if (dist[node_1] < ROUTE_INFINITY && route_add(dist[node_1], old_cost) == dist[node_2]) {
+            spf_region_add(scratch, &region_cnt, node_2);
+        }
+        if (dist[node_2] < ROUTE_INFINITY && route_add(dist[node_2], old_cost) == dist[node_1]) {
+            spf_region_add(scratch, &region_cnt, node_1);
+        }
+        if (region_cnt == 0) {
+            return;
+        }
+        spf_region_close(graph, dist, scratch, &region_cnt);
+
+        // 영역의 거리를 지우고, 영역 밖 이웃을 통해 들어오는 거리로 다시 시작
+        for (int i = 0; i < region_cnt; i++) {
+            dist[scratch->order[i]] = ROUTE_INFINITY;
+        }
+        for (int i = 0; i < region_cnt; i++) {
+            int x = scratch->order[i];
+            for (int k = graph->offset[x]; k < graph->offset[x] + graph->degree[x]; k++) {
+                int y = graph->adj[k];
+                if (!scratch->in_region[y] && route_add(dist[y], graph->weight[k]) < dist[x]) {
+                    dist[x] = route_add(dist[y], graph->weight[k]);
+                }
+            }
+            if (dist[x] < ROUTE_INFINITY) {
+                heap_push(&scratch->heap, x);
+                pushes++;
+            }
+        }
+
+        // 영역 안에서만 Dijkstra (영역 밖 노드의 거리는 줄어들 수 없음)
+        while (scratch->heap.size > 0) {
+            int current = heap_pop(&scratch->heap);
+            pops++;
+            for (int k = graph->offset[current]; k < graph->offset[current] + graph->degree[current]; k++) {
+                int dest = graph->adj[k];
+                int new_distance = route_add(dist[current], graph->weight[k]);
+                if (scratch->in_region[dest] && new_distance < dist[dest]) {
+                    dist[dest] = new_distance;
+                    heap_push(&scratch->heap, dest);
+                    pushes++;
+                    relaxed++;
+                }
+            }
+        }
+    } else {
+        // 새 비용으로 한쪽 끝이 짧아지거나 같은 비용의 경로가 생기는지 확인
+        for (int dir = 0; dir < 2; dir++) {
+            int from = dir == 0 ? node_1 : node_2;
+            int to = dir == 0 ? node_2 : node_1;
+            int new_distance = route_add(dist[from], new_cost);
+            if (new_distance >= ROUTE_INFINITY || new_distance > dist[to]) {
+                continue;
+            }
+            if (new_distance < dist[to]) {
+                dist[to] = new_distance;
+                heap_push(&scratch->heap, to);
+                pushes++;
+                relaxed++;
+            }
+            spf_region_add(scratch, &region_cnt, to);
+        }
+        if (region_cnt == 0) {
+            return;
+        }
+
+        // 짧아진 노드들로부터 Dijkstra
+        while (scratch->heap.size > 0) {
+            int current = heap_pop(&scratch->heap);
+            pops++;
+            for (int k = graph->offset[current]; k < graph->offset[current] + graph->degree[current]; k++) {
+                int dest = graph->adj[k];
+                int new_distance = route_add(dist[current], graph->weight[k]);
+                if (new_distance < dist[dest]) {
+                    dist[dest] = new_distance;
+                    heap_push(&scratch->heap, dest);
+                    pushes++;
+                    relaxed++;
+                }
+            }
+        }
+        spf_region_close(graph, dist, scratch, &region_cnt);
+    }
+
+    // 영역의 노드를 방문 순서대로 꺼내 다음 홉 결정
+    for (int i = 0; i < region_cnt; i++) {
+        int x = scratch->order[i];
+        next[x] = -1;
+        best[x] = -1;
+        if (dist[x] < ROUTE_INFINITY) {
+            heap_push(&scratch->heap, x);
+            pushes++;
+        } else {
+            scratch->in_region[x] = 0;
+        }
+    }
+    while (scratch->heap.size > 0) {
+        int x = heap_pop(&scratch->heap);
+        scratch->in_region[x] = 0;
+        resolve_next_hop(graph, start, x, dist, next, best);
+        pops++;
+    }
+    STAT_ADD(STAT_HEAP_PUSHES, pushes);
+    STAT_ADD(STAT_HEAP_POPS, pops);
+    STAT_ADD(STAT_RELAXATIONS, relaxed);
+}
+
+static void spf_repair_task(void* ctx, int worker, int start) {
+    RepairJob* job = (RepairJob*)ctx;
+    spf_repair_source(job->state, &job->state->scratch[worker], start, job->node_1, job->node_2, job->old_cost, job->new_cost);
+}
+
+// 변경 사항 하나를 그래프에 적용하고 영향을 받는 출발점만 복구
+void spf_apply_change(SpfState* state, int source, int destination, int distance) {
+    int old_cost = graph_link_cost(&state->graph, source, destination);
+    if (!graph_apply_change(&state->graph, source, destination, distance)) {
+        return;
+    }
+    RepairJob job;
+    job.state = state;
+    job.node_1 = source;
+    job.node_2 = destination;
+    job.old_cost = old_cost;
+    job.new_cost = graph_link_cost(&state->graph, source, destination);
+    pool_run(state->pool, state->node_cnt, spf_repair_task, &job);
+}
+
+// 스냅샷이 있으면 그 상태(변경 사항을 적용한 그래프)에서 시작 - 처음 테이블은 호출한 쪽이 스냅샷에서 복사
+void stream_engine_init(StreamEngine* engine, const Options* opts, const Topology* topology, WorkerPool* pool, const RouteSnapshot* snapshot) {
+    engine->opts = opts;
+    engine->topology = topology;
+    engine->pool = pool;
+    if (opts->engine == ENGINE_DYNAMIC) {
+        spf_state_init(&engine->state, topology, pool, snapshot);
+        engine->graph = &engine->state.graph;
+    } else {
+        graph_load(topology, &engine->loaded);
+        engine->graph = &engine->loaded;
+        int source, destination, distance;
+        for (int k = 0; snapshot && k < snapshot->header->change_cnt; k++) {
+            snapshot_change(snapshot, k, &source, &destination, &distance);
+            graph_apply_change(engine->graph, source, destination, distance);
+        }
+    }
+    arena_init(&engine->arena, arena_bytes(sizeof(bool) * topology->node_cnt));
+    engine->visited = (bool*)arena_alloc(&engine->arena, sizeof(bool) * topology->node_cnt);
+}
+
+void stream_engine_free(StreamEngine* engine) {
+    if (engine->opts->engine == ENGINE_DYNAMIC) {
+        spf_state_free(&engine->state);
+    } else {
+        graph_free(&engine->loaded);
+    }
+    arena_free(&engine->arena);
+}
+
+// 변경 사항 하나 적용 (동적 엔진은 영향을 받는 트리를 바로 고침)
+void stream_engine_apply(void* ctx, int source, int destination, int distance) {
+    StreamEngine* engine = (StreamEngine*)ctx;
+    if (engine->opts->engine == ENGINE_DYNAMIC) {
+        spf_apply_change(&engine->state, source, destination, distance);
+    } else {
+        graph_apply_change(engine->graph, source, destination, distance);
+    }
+}
+
+// 지금 그래프로 라우팅 테이블 계산
+void stream_engine_compute(void* ctx, int change, RouteTable* table) {
+    StreamEngine* engine = (StreamEngine*)ctx;
+    int node_cnt = engine->graph->node_cnt;
+    (void)change;
+    if (engine->opts->engine == ENGINE_DYNAMIC) {
+        for (int start = 0; start < node_cnt; start++) {
+            size_t row = (size_t)start * node_cnt;
+            route_store_row(table, start, engine->state.dist + row, engine->state.next + row);
+        }
+    } else if (engine->opts->engine == ENGINE_SPARSE) {
+        run_sparse_dijkstra(engine->graph, table, engine->pool);
+    } else if (engine->opts->engine == ENGINE_FW) {
+        load_network(engine->graph, table);
+        floyd_warshall(table, engine->pool);
+    } else {
+        load_network(engine->graph, table);
+        run_dijkstra(table, engine->visited);
+    }
+}
+
+// 지금 상태를 스냅샷으로 씀 (changes: 토폴로지 이후 적용한 변경 사항들, 동적 엔진은 best도 함께)
+void stream_engine_save(void* ctx, const Link* changes, int change_cnt, const RouteTable* table) {
+    StreamEngine* engine = (StreamEngine*)ctx;
+    const int* aux = engine->opts->engine == ENGINE_DYNAMIC ? engine->state.best : NULL;
+    save_snapshot(engine->opts, engine->topology, changes, change_cnt, table, aux);
+}
+
+// --load-snapshot 파일을 열어 지금 입력에 맞는지 확인 - 맞지 않으면 NULL (처음부터 계산)
+// with_changes가 0이면 변경 사항이 반영되지 않은 처음 상태의 스냅샷만 받음 (배치/스트림 모드는 변경 사항마다 출력하므로)
+const RouteSnapshot* open_snapshot(const Options* opts, const Topology* topology, RouteSnapshot* snapshot, int with_changes) {
+    if (!opts->load_snapshot || snapshot_open(snapshot, opts->load_snapshot, "linkstate", engine_names[opts->engine], topology) != 0) {
+        return NULL;
+    }
+    const char* reason = NULL;
+    if (!with_changes && snapshot->header->change_cnt > 0) {
+        reason = "holds applied changes, only the daemon resumes from those";
+    } else if (opts->engine == ENGINE_DYNAMIC && !snapshot->aux) {
+        reason = "no shortest path tree data";
+    }
+    if (reason) {
+        printf("Snapshot %s not loaded: %s\n", opts->load_snapshot, reason);
+        snapshot_close(snapshot);
+        return NULL;
+    }
+    printf("Loaded snapshot %s (%d changes)\n", opts->load_snapshot, snapshot->header->change_cnt);
+    return snapshot;
+}
+
+// --save-snapshot 파일에 테이블을 씀
+void save_snapshot(const Options* opts, const Topology* topology, const Link* changes, int change_cnt, const RouteTable* table, const int* aux) {
+    if (opts->save_snapshot) {
+        snapshot_save(opts->save_snapshot, "linkstate", engine_names[opts->engine], topology, changes, change_cnt, table, aux);
+    }
+}
+
+// 스트림 모드 - 토폴로지는 한 번만 읽고 그래프를 유지하면서 변경 사항을 한 줄씩 한 번만 적용
+// 변경 사항마다 선택한 엔진으로 라우팅 테이블을 계산하고 결과를 바로 출력
+void run_stream_engine(const Options* opts, const Topology* topology, MessageBatch* messages, FILE* changesfile, const ChangeList* changes, OutBuf* out, WorkerPool* pool, const RouteSnapshot* snapshot) {
+    StreamEngine engine;
+    RouteTable table;
+    ChangeStream stream;
+    ChangeBatch batch;
+
+    stream_engine_init(&engine, opts, topology, pool, snapshot);
+    route_table_init(&table, engine.graph->node_cnt, graph_max_weight(engine.graph));
+    change_stream_init(&stream, changesfile, changes, topology->node_cnt, opts->follow);
+
+    change_batch_init(&batch, &opts->batch);
+
+    // 변경 사항 묶음마다 (묶지 않으면 변경 사항 하나마다) 한 번 계산하고 출력
+    for (int change = 0; ; change++) {
+        if (change != 0) {
+            if (!change_batch_next(&batch, &stream)) {
+                break;
+            }
+            for (int k = 0; k < batch.change_cnt; k++) {
+                int distance = batch.changes[k].cost;
+                if (distance >= 0 && distance < LINK_NONE) {
+                    route_table_reserve(&table, distance);
+                }
+            }
+            int net_cnt = change_batch_coalesce(&batch, engine.graph);
+            for (int k = 0; k < net_cnt; k++) {
+                stream_engine_apply(&engine, batch.net[k].src, batch.net[k].dst, batch.net[k].cost);
+            }
+        }
+
+        if (change == 0 && snapshot) {
+            route_table_copy(&table, &snapshot->table);
+        } else {
+            stream_engine_compute(&engine, change, &table);
+        }
+        if (change == 0) {
+            stream_engine_save(&engine, NULL, 0, &table);
+        }
+        timer_event();
+        RouteView view = route_view_table(&table);
+        stats_event(&view);
+        net_print(out, &table);
+        timer_add(&phase_timer.output);
+        message_batch_write(out, messages, &view);
+        timer_add(&phase_timer.trace);
+        stats_event_output(out_total(out));
+        out_flush(out); // 변경 사항마다 결과를 바로 볼 수 있도록
+        timer_add(&phase_timer.output);
+    }
+
+    change_batch_report(&batch);
+    change_batch_free(&batch);
+    change_stream_free(&stream);
+    route_table_free(&table);
+    stream_engine_free(&engine);
+}
+
+// 데몬 모드 - 토폴로지만 읽고 변경 사항과 질의는 소켓으로 받음 (lazy 외의 엔진, 재계산은 백그라운드 스레드)
+void run_daemon(const Options* opts, int argc, char** argv) {
+    if (argc != 2 || opts->engine == ENGINE_LAZY || opts->engine == ENGINE_CH) {
+        printf("usage: linkstate -D socket [-e dense|sparse|dynamic|fw] [-j threads] [--save-snapshot file] [--load-snapshot file] topologyfile\n");
+        exit(0);
+    }
+    FILE* topologyfile = fopen(argv[1], "r");
+    if (!topologyfile) {
+        printf("Error: open input file\n");
+        exit(0);
+    }
+    Topology topology;
+    int loaded = topology_load(&topology, topologyfile) == 0;
+    fclose(topologyfile);
+    if (!loaded) {
+        topology_free(&topology);
+        exit(0);
+    }
+
+    // 스냅샷이 있으면 그 변경 사항들까지 반영된 상태에서 이어 감
+    RouteSnapshot snapshot;
+    const RouteSnapshot* initial = open_snapshot(opts, &topology, &snapshot, 1);
+    ChangeList history = {NULL, 0};
+    if (initial) {
+        history.change_cnt = initial->header->change_cnt;
+        history.changes = (Link*)malloc(sizeof(Link) * (history.change_cnt > 0 ? history.change_cnt : 1));
+        for (int k = 0; k < history.change_cnt; k++) {
+            snapshot_change(initial, k, &history.changes[k].src, &history.changes[k].dst, &history.changes[k].cost);
+            history.changes[k].line = 0;
+        }
+    }
+
+    WorkerPool pool;
+    StreamEngine engine;
+    pool_init(&pool, opts->threads);
+    stream_engine_init(&engine, opts, &topology, &pool, initial);
+    DaemonEngine daemon_engine = {&engine, stream_engine_apply, stream_engine_compute, opts->save_snapshot ? stream_engine_save : NULL,
+                                  initial ? &initial->table : NULL, history.changes, history.change_cnt};
+    int max_weight = graph_max_weight(engine.graph);
+    if (initial && initial->table.max_weight > max_weight) {
+        max_weight = initial->table.max_weight;
+    }
+    daemon_run(opts->daemon, engine.graph->node_cnt, max_weight, &daemon_engine);
+    stream_engine_free(&engine);
+    pool_free(&pool);
+    if (initial) {
+        snapshot_close(&snapshot);
+    }
+    changes_free(&history);
+    topology_free(&topology);
+}
+
+// 기본 경로 - 출발점 하나를 계산해 job의 N x N 배열에 기록
+static void what_if_base_task(void* ctx, int worker, int start) {
+    WhatIfJob* job = (WhatIfJob*)ctx;
+    size_t row = (size_t)start * job->graph->node_cnt;
+    sparse_shortest_paths(job->graph, start, job->dist + row, job->next + row, job->best + row, &job->workers[worker].scratch);
+}
+
+// 스레드의 그래프 사본에서 링크 하나를 빼고, 그 링크가 최단 경로에 쓰인 출발점의 행만 복사해서 고침 (이미 빠진 링크면 무시)
+void what_if_fail_link(const WhatIfJob* job, WhatIfWorker* worker, int u, int v) {
+    int slot = graph_find(&worker->graph, u, v);
+    if (slot < 0) {
+        return;
+    }
+    int cost = worker->graph.weight[slot];
+    if (worker->removed_cnt == worker->removed_cap) {
+        worker->removed_cap *= 2;
+        worker->removed = (Link*)realloc(worker->removed, sizeof(Link) * worker->removed_cap);
+    }
+    Link* link = &worker->removed[worker->removed_cnt++];
+    link->src = u;
+    link->dst = v;
+    link->cost = cost;
+    graph_remove_link(&worker->graph, u, v);
+
+    int node_cnt = worker->graph.node_cnt;
+    for (int start = 0; start < node_cnt; start++) {
+        if (worker->failed[start]) {
+            continue;
+        }
+        size_t row = (size_t)start * node_cnt;
+        int copied = worker->row_of[start];
+        const int* dist = copied < 0 ? job->dist + row : worker->rows + (size_t)copied * 3 * node_cnt;
+        if (!spf_tree_affected(dist, u, v, cost, ROUTE_INFINITY)) {
+            continue;
+        }
+        if (copied < 0) {
+            if (worker->row_cnt == worker->row_cap) {
+                worker->row_cap *= 2;
+                worker->rows = (int*)realloc(worker->rows, sizeof(int) * 3 * node_cnt * (size_t)worker->row_cap);
+            }
+            copied = worker->row_of[start] = worker->row_cnt++;
+            worker->owner[copied] = start;
+            int* own = worker->rows + (size_t)copied * 3 * node_cnt;
+            memcpy(own, job->dist + row, sizeof(int) * node_cnt);
+            memcpy(own + node_cnt, job->next + row, sizeof(int) * node_cnt);
+            memcpy(own + 2 * node_cnt, job->best + row, sizeof(int) * node_cnt);
+        }
+        int* own = worker->rows + (size_t)copied * 3 * node_cnt;
+        spf_repair_row(&worker->graph, &worker->scratch, start, own, own + node_cnt, own + 2 * node_cnt, u, v, cost, ROUTE_INFINITY);
+    }
+}
+
+// 시나리오 하나 - 고장을 하나씩 적용하며 영향을 받은 행만 고치고, 고친 행을 기본 경로와 비교한 뒤 그래프를 되돌림
+// (다음 홉은 거리와 노드 번호로만 정해지므로 인접 목록의 순서가 바뀌어도 결과는 같음)
+static void what_if_scenario_task(void* ctx, int worker, int index) {
+    WhatIfJob* job = (WhatIfJob*)ctx;
+    WhatIfWorker* self = &job->workers[worker];
+    const Scenario* scenario = &job->list->scenarios[index];
+    const Failure* failures = job->list->failures + scenario->first;
+    ScenarioResult* result = &job->results[index];
+    int node_cnt = job->graph->node_cnt;
+
+    self->removed_cnt = 0;
+    self->row_cnt = 0;
+    for (int i = 0; i < scenario->cnt; i++) {
+        if (failures[i].v < 0) {
+            self->failed[failures[i].u] = 1;
+        }
+    }
+    for (int i = 0; i < scenario->cnt; i++) {
+        int x = failures[i].u;
+        if (failures[i].v >= 0) {
+            what_if_fail_link(job, self, x, failures[i].v);
+            continue;
+        }
+        while (self->graph.degree[x] > 0) {
+            what_if_fail_link(job, self, x, self->graph.adj[self->graph.offset[x]]);
+        }
+    }
+
+    memset(result, 0, sizeof(*result));
+    for (int r = 0; r < self->row_cnt; r++) {
+        int start = self->owner[r];
+        size_t row = (size_t)start * node_cnt;
+        const int* own = self->rows + (size_t)r * 3 * node_cnt;
+        scenario_compare_row(result, job->dist + row, job->next + row, own, own + node_cnt, self->failed, start, node_cnt);
+        self->row_of[start] = -1;
+    }
+
+    for (int i = self->removed_cnt - 1; i >= 0; i--) {
+        graph_set_link(&self->graph, self->removed[i].src, self->removed[i].dst, self->removed[i].cost);
+    }
+    for (int i = 0; i < scenario->cnt; i++) {
+        if (failures[i].v < 0) {
+            self->failed[failures[i].u] = 0;
+        }
+    }
+}
+
+// 고장 시나리오 모드 - 토폴로지를 한 번 읽어 기본 경로를 한 번 계산하고, 시나리오들을 스레드 풀로 나눠 평가
+// 시나리오마다 한 줄 요약을 output_ls.txt에 기록
+void run_what_if(const Options* opts, int argc, char** argv) {
+    if (argc != 2) {
+        printf("usage: linkstate --what-if links|nodes|scenariofile [-j threads] topologyfile\n");
+        exit(0);
+    }
+    int all_links = strcmp(opts->what_if, "links") == 0;
+    int all_nodes = strcmp(opts->what_if, "nodes") == 0;
+    FILE* topologyfile = fopen(argv[1], "r");
+    FILE* scenariofile = all_links || all_nodes ? NULL : fopen(opts->what_if, "r");
+    FILE* outputfile = fopen("output_ls.txt", "w");
+    if (!topologyfile || (!all_links && !all_nodes && !scenariofile) || !outputfile) {
+        printf("Error: open input file\n");
+        if (topologyfile) fclose(topologyfile);
+        if (scenariofile) fclose(scenariofile);
+        if (outputfile) fclose(outputfile);
+        exit(0);
+    }
+
+    Topology topology;
+    Graph graph;
+    ScenarioList list;
+    timer_start();
+    int loaded = topology_load(&topology, topologyfile) == 0;
+    scenario_list_init(&list);
+    if (loaded) {
+        graph_load(&topology, &graph);
+        if (all_links) {
+            scenario_list_links(&list, &graph);
+        } else if (all_nodes) {
+            scenario_list_nodes(&list, graph.node_cnt);
+        } else if (scenario_list_load(&list, scenariofile, &graph) != 0) {
+            graph_free(&graph);
+            loaded = 0;
+        }
+    }
+    timer_add(&phase_timer.parse);
+
+    if (loaded) {
+        int node_cnt = graph.node_cnt;
+        size_t cells = (size_t)node_cnt * node_cnt;
+        WorkerPool pool;
+        WhatIfJob job;
+        pool_init(&pool, opts->threads);
+        job.graph = &graph;
+        job.dist = (int*)malloc(sizeof(int) * (cells > 0 ? cells : 1));
+        job.next = (int*)malloc(sizeof(int) * (cells > 0 ? cells : 1));
+        job.best = (int*)malloc(sizeof(int) * (cells > 0 ? cells : 1));
+        job.list = &list;
+        job.results = (ScenarioResult*)calloc(list.scenario_cnt > 0 ? list.scenario_cnt : 1, sizeof(ScenarioResult));
+        job.workers = (WhatIfWorker*)malloc(sizeof(WhatIfWorker) * pool.thread_cnt);
+        for (int i = 0; i < pool.thread_cnt; i++) {
+            WhatIfWorker* worker = &job.workers[i];
+            graph_load(&topology, &worker->graph);
+            spf_scratch_init(&worker->scratch, node_cnt);
+            worker->removed_cap = 16;
+            worker->removed = (Link*)malloc(sizeof(Link) * worker->removed_cap);
+            worker->removed_cnt = 0;
+            worker->failed = (char*)calloc(node_cnt > 0 ? node_cnt : 1, 1);
+            worker->row_of = (int*)malloc(sizeof(int) * (node_cnt > 0 ? node_cnt : 1));
+            worker->owner = (int*)malloc(sizeof(int) * (node_cnt > 0 ? node_cnt : 1));
+            for (int start = 0; start < node_cnt; start++) {
+                worker->row_of[start] = -1;
+            }
+            worker->row_cap = 4;
+            worker->rows = (int*)malloc(sizeof(int) * 3 * (node_cnt > 0 ? node_cnt : 1) * (size_t)worker->row_cap);
+            worker->row_cnt = 0;
+        }
+
+        pool_run(&pool, node_cnt, what_if_base_task, &job);
+        timer_event();
+        pool_run(&pool, list.scenario_cnt, what_if_scenario_task, &job);
+        timer_event();
+
+        int disconnecting = 0;
+        for (int k = 0; k < list.scenario_cnt; k++) {
+            scenario_write(outputfile, &list, k, &job.results[k]);
+            disconnecting += job.results[k].unreachable > 0;
+        }
+        timer_add(&phase_timer.output);
+        printf("Evaluated %d scenarios (%d leave node pairs unreachable)\n", list.scenario_cnt, disconnecting);
+        printf("Complete. Output file written to output_ls.txt.\n");
+        timer_report();
+
+        for (int i = 0; i < pool.thread_cnt; i++) {
+            graph_free(&job.workers[i].graph);
+            spf_scratch_free(&job.workers[i].scratch);
+            free(job.workers[i].removed);
+            free(job.workers[i].failed);
+            free(job.workers[i].row_of);
+            free(job.workers[i].owner);
+            free(job.workers[i].rows);
+        }
+        free(job.workers);
+        free(job.results);
+        free(job.dist);
+        free(job.next);
+        free(job.best);
+        pool_free(&pool);
+        graph_free(&graph);
+    }
+    scenario_list_free(&list);
+    topology_free(&topology);
+    fclose(topologyfile);
+    if (scenariofile) fclose(scenariofile);
+    fclose(outputfile);
+}
+
+// 변경된 링크 (node_1, node_2)가 출발점 하나의 트리에 영향을 주는지 확인 (spf_repair_source와 같은 기준)
+// 비용 증가/제거: 그 링크가 최단 경로에 쓰였을 때, 감소/추가: 한쪽 끝이 짧아지거나 같은 비용의 경로가 생길 때
+int spf_tree_affected(const int* dist, int node_1, int node_2, int old_cost, int new_cost) {
+    for (int dir = 0; dir < 2; dir++) {
+        int from = dir == 0 ? node_1 : node_2;
+        int to = dir == 0 ? node_2 : node_1;
+        if (new_cost > old_cost) {
+            if (dist[from] < ROUTE_INFINITY && route_add(dist[from], old_cost) == dist[to]) {
+                return 1;
             }
         } else {
-            return -1; // 파일 읽기 오류 발생 시 -1 반환
+            int new_distance = route_add(dist[from], new_cost);
+            if (new_distance < ROUTE_INFINITY && new_distance <= dist[to]) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// 캐시 할당 - 트리 하나에 거리와 다음 홉 배열(int 2 * node_cnt개)이 필요하며 최소 한 개는 보관
+void lazy_cache_init(LazyCache* cache, const Graph* graph, long long cache_bytes) {
+    int node_cnt = graph->node_cnt > 0 ? graph->node_cnt : 1;
+    long long tree_bytes = (long long)sizeof(int) * 2 * node_cnt;
+    long long capacity = cache_bytes / tree_bytes;
+    if (capacity < 1) {
+        capacity = 1;
+    }
+    if (capacity > node_cnt) {
+        capacity = node_cnt;
+    }
+
+    cache->graph = graph;
+    cache->node_cnt = graph->node_cnt;
+    cache->capacity = (int)capacity;
+    cache->used = 0;
+    cache->head = cache->tail = -1;
+    cache->slot_of = (int*)malloc(sizeof(int) * node_cnt);
+    cache->source = (int*)malloc(sizeof(int) * capacity);
+    cache->newer = (int*)malloc(sizeof(int) * capacity);
+    cache->older = (int*)malloc(sizeof(int) * capacity);
+    cache->dist = (int*)malloc(sizeof(int) * capacity * node_cnt);
+    cache->next = (int*)malloc(sizeof(int) * capacity * node_cnt);
+    for (int i = 0; i < node_cnt; i++) {
+        cache->slot_of[i] = -1;
+    }
+    spf_scratch_init(&cache->scratch, node_cnt);
+}
+
+void lazy_cache_free(LazyCache* cache) {
+    free(cache->slot_of);
+    free(cache->source);
+    free(cache->newer);
+    free(cache->older);
+    free(cache->dist);
+    free(cache->next);
+    spf_scratch_free(&cache->scratch);
+}
+
+// LRU 리스트에서 슬롯을 빼거나 맨 앞(가장 최근)에 넣음
+static void lazy_unlink(LazyCache* cache, int slot) {
+    if (cache->newer[slot] >= 0) cache->older[cache->newer[slot]] = cache->older[slot];
+    else cache->head = cache->older[slot];
+    if (cache->older[slot] >= 0) cache->newer[cache->older[slot]] = cache->newer[slot];
+    else cache->tail = cache->newer[slot];
+}
+
+static void lazy_push_front(LazyCache* cache, int slot) {
+    cache->newer[slot] = -1;
+    cache->older[slot] = cache->head;
+    if (cache->head >= 0) cache->newer[cache->head] = slot;
+    cache->head = slot;
+    if (cache->tail < 0) cache->tail = slot;
+}
+
+// 출발점 start의 트리가 있는 슬롯 반환 - 없으면 (가득 찼으면 가장 오래 쓰지 않은 트리를 내보내고) 계산
+int lazy_cache_tree(LazyCache* cache, int start) {
+    int slot = cache->slot_of[start];
+    if (slot >= 0) {
+        if (cache->head != slot) {
+            lazy_unlink(cache, slot);
+            lazy_push_front(cache, slot);
+        }
+        return slot;
+    }
+
+    if (cache->used < cache->capacity) {
+        slot = cache->used++;
+    } else {
+        slot = cache->tail;
+        lazy_unlink(cache, slot);
+        cache->slot_of[cache->source[slot]] = -1;
+    }
+    size_t row = (size_t)slot * cache->node_cnt;
+    sparse_shortest_paths(cache->graph, start, cache->dist + row, cache->next + row, cache->scratch.best, &cache->scratch);
+    cache->source[slot] = start;
+    cache->slot_of[start] = slot;
+    lazy_push_front(cache, slot);
+    return slot;
+}
+
+// 변경 사항 하나를 그래프에 적용하고 영향을 받는 캐시된 트리만 버림
+// 비용 0인 링크도 같은 기준으로 충분함 - 두 끝에 도달하는 트리에서는 항상 최단 경로에 쓰이므로(거리가 같음) 버려지고,
+// 버리지 않은 트리는 그 링크와 상관없이 방문 순서(resolve_zero_cost_hops)가 그대로임
+// 버린 슬롯은 마지막 슬롯을 옮겨 채워 사용 중인 슬롯이 앞쪽에 모여 있도록 유지
+void lazy_apply_change(LazyCache* cache, Graph* graph, int source, int destination, int distance) {
+    int old_cost = graph_link_cost(graph, source, destination);
+    if (!graph_apply_change(graph, source, destination, distance)) {
+        return;
+    }
+    int new_cost = graph_link_cost(graph, source, destination);
+    int node_cnt = cache->node_cnt;
+
+    for (int slot = cache->used - 1; slot >= 0; slot--) {
+        if (!spf_tree_affected(cache->dist + (size_t)slot * node_cnt, source, destination, old_cost, new_cost)) {
+            continue;
+        }
+        lazy_unlink(cache, slot);
+        cache->slot_of[cache->source[slot]] = -1;
+        int last = --cache->used;
+        if (slot != last) {
+            // 마지막 슬롯의 트리를 빈 슬롯으로 옮김 (LRU 위치는 그대로)
+            int newer = cache->newer[last], older = cache->older[last];
+            memcpy(cache->dist + (size_t)slot * node_cnt, cache->dist + (size_t)last * node_cnt, sizeof(int) * node_cnt);
+            memcpy(cache->next + (size_t)slot * node_cnt, cache->next + (size_t)last * node_cnt, sizeof(int) * node_cnt);
+            cache->source[slot] = cache->source[last];
+            cache->slot_of[cache->source[slot]] = slot;
+            cache->newer[slot] = newer;
+            cache->older[slot] = older;
+            if (newer >= 0) cache->older[newer] = slot;
+            else cache->head = slot;
+            if (older >= 0) cache->newer[older] = slot;
+            else cache->tail = slot;
+        }
+    }
+}
+
+// 메시지 엔진이 읽는 라우팅 정보 - 라우터마다 자기 트리(없으면 계산)의 칸을 보여줌
+static uint32_t lazy_view_dist(void* ctx, int from, int to) {
+    LazyCache* cache = (LazyCache*)ctx;
+    size_t cell = (size_t)lazy_cache_tree(cache, from) * cache->node_cnt + to;
+    return cache->next[cell] >= 0 ? (uint32_t)cache->dist[cell] : ROUTE_NONE;
+}
+
+static uint32_t lazy_view_next(void* ctx, int from, int to) {
+    LazyCache* cache = (LazyCache*)ctx;
+    size_t cell = (size_t)lazy_cache_tree(cache, from) * cache->node_cnt + to;
+    return cache->next[cell] >= 0 ? (uint32_t)cache->next[cell] : ROUTE_NONE;
+}
+
+RouteView lazy_route_view(LazyCache* cache) {
+    RouteView view;
+    view.node_cnt = cache->node_cnt;
+    view.dist = lazy_view_dist;
+    view.next = lazy_view_next;
+    view.ctx = cache;
+    return view;
+}
+
+// lazy 엔진 - 그래프만 유지하고, 트리는 메시지를 보낼 때(또는 -p 출력 시) 필요한 출발점만 계산
+void run_lazy_engine(const Options* opts, const Topology* topology, MessageBatch* messages, FILE* changesfile, const ChangeList* changes, OutBuf* out) {
+    Graph graph;
+    LazyCache cache;
+    ChangeStream stream;
+    ChangeBatch batch;
+
+    graph_load(topology, &graph);
+    lazy_cache_init(&cache, &graph, opts->cache_bytes);
+    change_stream_init(&stream, changesfile, changes, topology->node_cnt, opts->follow);
+
+    change_batch_init(&batch, &opts->batch);
+
+    for (int change = 0; ; change++) {
+        if (change != 0) {
+            if (!change_batch_next(&batch, &stream)) {
+                break;
+            }
+            int net_cnt = change_batch_coalesce(&batch, &graph);
+            for (int k = 0; k < net_cnt; k++) {
+                lazy_apply_change(&cache, &graph, batch.net[k].src, batch.net[k].dst, batch.net[k].cost);
+            }
+        }
+        // lazy 엔진은 트리를 출력과 메시지 경로를 만들 때 계산하므로 변경 사항 시간에는 변경 적용만 들어감
+        // (통계는 트리 계산 카운터까지 묶도록 메시지 경로를 만든 뒤에 기록)
+        timer_event();
+        RouteView view = lazy_route_view(&cache);
+        if (opts->print) {
+            out_routes(out, &view); // 요청한 경우(-p)에만 전체 라우팅 테이블 출력
+            timer_add(&phase_timer.output);
+        }
+        message_batch_write(out, messages, &view);
+        timer_add(&phase_timer.trace);
+        stats_event(opts->print ? &view : NULL);
+        stats_event_output(out_total(out));
+        out_flush(out); // 변경 사항마다 결과를 바로 볼 수 있도록
+        timer_add(&phase_timer.output);
+    }
+
+    change_batch_report(&batch);
+    change_batch_free(&batch);
+    change_stream_free(&stream);
+    lazy_cache_free(&cache);
+    graph_free(&graph);
+}
+
+// ch 엔진 - 그래프와 축약 계층만 유지하고, 변경 사항이 있으면 계층을 낡은 것으로 표시만 함
+// (그동안은 그래프 탐색으로 답하고, 그 탐색 비용이 마지막 축약의 비용만큼 쌓이면 같은 순서로 다시 축약)
+// 메시지(와 -p 출력)의 칸은 그때그때 질의하며, 거리는 다른 엔진과 같고 같은 비용 경로가 여럿이면 고르는 경로가 다를 수 있음
+void run_ch_engine(const Options* opts, const Topology* topology, MessageBatch* messages, FILE* changesfile, const ChangeList* changes, OutBuf* out) {
+    Graph graph;
+    ContractionHierarchy ch;
+    ChangeStream stream;
+    ChangeBatch batch;
+
+    graph_load(topology, &graph);
+    ch_build(&ch, &graph);
+    change_stream_init(&stream, changesfile, changes, topology->node_cnt, opts->follow);
+
+    change_batch_init(&batch, &opts->batch);
+
+    for (int change = 0; ; change++) {
+        if (change != 0) {
+            if (!change_batch_next(&batch, &stream)) {
+                break;
+            }
+            int net_cnt = change_batch_coalesce(&batch, &graph);
+            for (int k = 0; k < net_cnt; k++) {
+                if (graph_apply_change(&graph, batch.net[k].src, batch.net[k].dst, batch.net[k].cost)) {
+                    ch_mark_stale(&ch, &graph);
+                }
+            }
+            ch_forget_last_query(&ch);
+        }
+        timer_event();
+        RouteView view = ch_route_view(&ch);
+        if (opts->print) {
+            out_routes(out, &view); // 요청한 경우(-p)에만 전체 라우팅 테이블 출력
+            timer_add(&phase_timer.output);
+        }
+        message_batch_write(out, messages, &view);
+        timer_add(&phase_timer.trace);
+        stats_event(opts->print ? &view : NULL);
+        stats_event_output(out_total(out));
+        out_flush(out); // 변경 사항마다 결과를 바로 볼 수 있도록
+        timer_add(&phase_timer.output);
+    }
+
+    change_batch_report(&batch);
+    change_batch_free(&batch);
+    change_stream_free(&stream);
+    ch_report(&ch);
+    ch_free(&ch);
+    graph_free(&graph);
+}
+
+// 두 노드 사이의 거리를 무한대로 설정하는 함수
+void set_infinite_distance(RouteTable* table, int node_1, int node_2) {
+    route_set(table, node_1, node_2, ROUTE_NONE, ROUTE_NONE);
+    route_set(table, node_2, node_1, ROUTE_NONE, ROUTE_NONE);
+}
+
+// 네트워크 변경 및 거리 업데이트 함수
+int change_network(const ChangeList* changes, RouteTable* table, int change) {
+    int node_cnt = table->node_cnt;
+
+    if (change > changes->change_cnt) {
+        return -1; // 변경 사항을 모두 적용했으면 -1 반환
+    }
+    for (int i = 0; i < change; i++) {
+        int source = changes->changes[i].src;
+        int destination = changes->changes[i].dst;
+        int distance = changes->changes[i].cost;
+        uint32_t current = route_get_dist(table, source, destination);
+        if (distance == LINK_DOWN) {
+            // 노드 간의 거리를 무한대로 설정하고 다음 홉을 없앰
+            set_infinite_distance(table, source, destination);
+        } else if (distance >= 0 && distance < LINK_NONE && (current == ROUTE_NONE || current > (uint32_t)distance)) {
+            // 새로운 거리가 현재 거리보다 짧은 경우 거리를 업데이트 (링크가 없으면 LINK_NONE보다 짧아야 함)
+            route_table_reserve(table, distance);
+            route_set(table, source, destination, (uint32_t)distance, (uint32_t)destination);
+            route_set(table, destination, source, (uint32_t)distance, (uint32_t)source);
         }
     }
 
     // 노드 간의 경로를 확인하고 특정 조건에 따라 거리를 무한대로 설정
     for (int i = 0; i < node_cnt; i++) {
         for (int j = 0; j < node_cnt; j++) {
-            if (((*network)[i][j].destination - '0') == 1 && ((*network)[i][j].next - '0') == 2) {
-                set_infinite_distance(network, i, j);
+            if (j == 1 && route_get_next(table, i, j) == 2) {
+                set_infinite_distance(table, i, j);
             }
-            if (((*network)[i][j].destination - '0') == 2 && ((*network)[i][j].next - '0') == 1) {
-                set_infinite_distance(network, i, j);
+            if (j == 2 && route_get_next(table, i, j) == 1) {
+                set_infinite_distance(table, i, j);
             }
         }
     }
@@ -0,0 +1,47 @@
+#ifndef ROUTING_ARENA_H
+#define ROUTING_ARENA_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// 실행 동안 계속 쓰는 메모리 영역 - 입력을 읽은 뒤 필요한 크기를 더해 한 번만 할당하고 나눠 씀
+// 변경 사항마다 라우팅 테이블과 작업 배열(visited, 인접 노드 목록)을 다시 할당하지 않고 같은 자리를 다시 씀
+// 구간은 캐시 줄 경계(64바이트)에서 시작하며, 크기를 넘겨 요청하면 오류 (크기 계산이 잘못된 경우)
+
+#define ARENA_ALIGN 64
+
+typedef struct Arena_ {
+    char* base;
+    size_t size;
+    size_t used;
+} Arena;
+
+// 구간 하나가 차지하는 크기 (경계 맞춤 포함) - arena_init에 넘길 크기는 이 값들의 합
+static inline size_t arena_bytes(size_t bytes) {
+    return (bytes + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+}
+
+static inline void arena_init(Arena* arena, size_t size) {
+    arena->size = arena_bytes(size);
+    arena->base = (char*)aligned_alloc(ARENA_ALIGN, arena->size > 0 ? arena->size : ARENA_ALIGN);
+    arena->used = 0;
+}
+
+static inline void arena_free(Arena* arena) {
+    free(arena->base);
+    arena->base = NULL;
+    arena->size = arena->used = 0;
+}
+
+static inline void* arena_alloc(Arena* arena, size_t bytes) {
+    size_t need = arena_bytes(bytes);
+    if (need > arena->size - arena->used) {
+        printf("Error: arena exhausted (%zu of %zu bytes used, %zu requested)\n", arena->used, arena->size, need);
+        exit(0);
+    }
+    void* block = arena->base + arena->used;
+    arena->used += need;
+    return block;
+}
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef ROUTING_BATCH_H
+#define ROUTING_BATCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "routing_graph.h"
+#include "routing_input.h"
+#include "routing_stream.h"
+
+// 변경 사항 묶기 (-b N, -w MS) - 라우터가 SPF 실행을 미뤄 모아서 하듯이 여러 변경 사항을 한 번의 계산과 출력으로 처리
+// 묶음은 변경 사항 N개, 또는 첫 변경 사항의 시각(변경 파일의 네 번째 열, ms)부터 MS 안에 든 변경 사항들 (둘 다 주면 먼저 차는 쪽)
+// 묶음 안의 변경 사항은 링크별로 합쳐서, 하나씩 적용했을 때와 같은 최종 링크 상태가 되는 변경만 엔진에 넘김
+// (끊겼다가 같은 비용으로 돌아온 링크처럼 묶음 안에서 되돌아간 변경은 없어짐)
+// 시각으로 묶을 때는 범위를 벗어난 다음 변경 사항을 읽어야 묶음이 끝나므로 follow 모드에서는 그 줄이 올 때까지 기다림
+
+typedef struct BatchOptions_ {
+    int size;           // 묶음당 최대 변경 사항 수 (0이면 제한 없음)
+    long long window;   // 묶음의 시각 범위 (ms, 0이면 시각으로 묶지 않음)
+} BatchOptions;
+
+// 정렬용 - 링크(작은 번호, 큰 번호)와 읽은 순서
+typedef struct BatchEntry_ {
+    int u;
+    int v;
+    int seq;
+} BatchEntry;
+
+typedef struct ChangeBatch_ {
+    BatchOptions opts;
+    Link* changes;      // 이번 묶음에서 읽은 변경 사항 (읽은 순서)
+    int change_cnt;
+    Link* net;          // 링크별로 합친 변경 사항 (링크마다 많아야 둘 - 끊김 뒤 새 비용)
+    int net_cnt;
+    BatchEntry* entries;
+    int cap;
+    Link pending;       // 시각 범위를 벗어나 다음 묶음으로 넘긴 변경 사항
+    int has_pending;
+    int batch_cnt;      // 지금까지 읽은 묶음 수
+    long long total;    // 지금까지 읽은 변경 사항 수
+    long long cancelled; // 묶음 안에서 되돌아가 없어진 링크 변경 수
+} ChangeBatch;
+
+// -b나 -w를 주었는지 (변경 파일의 네 번째 열을 시각으로 읽음)
+static inline int batch_enabled(const BatchOptions* opts) {
+    return opts->size > 0 || opts->window > 0;
+}
+
+static inline void change_batch_init(ChangeBatch* batch, const BatchOptions* opts) {
+    batch->opts = *opts;
+    batch->cap = 16;
+    batch->changes = (Link*)malloc(sizeof(Link) * batch->cap);
+    batch->net = (Link*)malloc(sizeof(Link) * 2 * batch->cap);
+    batch->entries = (BatchEntry*)malloc(sizeof(BatchEntry) * batch->cap);
+    batch->change_cnt = batch->net_cnt = 0;
+    memset(&batch->pending, 0, sizeof(batch->pending));
+    batch->has_pending = 0;
+    batch->batch_cnt = 0;
+    batch->total = batch->cancelled = 0;
+}
+
+static inline void change_batch_free(ChangeBatch* batch) {
+    free(batch->changes);
+    free(batch->net);
+    free(batch->entries);
+    batch->changes = batch->net = NULL;
+    batch->entries = NULL;
+}
+
+// 다음 묶음을 읽음. 변경 사항을 하나 이상 읽었으면 1, 스트림이 끝났으면 0
+static inline int change_batch_next(ChangeBatch* batch, ChangeStream* stream) {
+    int limit = batch->opts.size > 0 ? batch->opts.size : (batch->opts.window > 0 ? INT_MAX : 1);
+    Link change;
+    batch->change_cnt = 0;
+    while (batch->change_cnt < limit) {
+        if (batch->has_pending) {
+            change = batch->pending;
+            batch->has_pending = 0;
+        } else if (change_stream_next(stream, &change.src, &change.dst, &change.cost)) {
+            change.line = stream->line_no;
+            change.time = stream->time;
+        } else {
+            break;
+        }
+        if (batch->opts.window > 0 && batch->change_cnt > 0 && change.time - batch->changes[0].time >= batch->opts.window) {
+            batch->pending = change;
+            batch->has_pending = 1;
+            break;
+        }
+        if (batch->change_cnt == batch->cap) {
+            batch->cap *= 2;
+            batch->changes = (Link*)realloc(batch->changes, sizeof(Link) * batch->cap);
+            batch->net = (Link*)realloc(batch->net, sizeof(Link) * 2 * batch->cap);
+            batch->entries = (BatchEntry*)realloc(batch->entries, sizeof(BatchEntry) * batch->cap);
+        }
+        batch->changes[batch->change_cnt++] = change;
+    }
+    if (batch->change_cnt == 0) {
+        return 0;
+    }
+    batch->batch_cnt++;
+    batch->total += batch->change_cnt;
+    return 1;
+}
+
+static inline int batch_entry_compare(const void* a, const void* b) {
+    const BatchEntry* x = (const BatchEntry*)a;
+    const BatchEntry* y = (const BatchEntry*)b;
+    if (x->u != y->u) {
+        return x->u < y->u ? -1 : 1;
+    }
+    if (x->v != y->v) {
+        return x->v < y->v ? -1 : 1;
+    }
+    return x->seq < y->seq ? -1 : (x->seq > y->seq);
+}
+
+static inline void change_batch_emit(ChangeBatch* batch, int u, int v, int cost) {
+    Link* link = &batch->net[batch->net_cnt++];
+    link->src = u;
+    link->dst = v;
+    link->cost = cost;
+    link->line = 0;
+    link->time = 0;
+}
+
+// 묶음의 변경 사항을 링크별로 합쳐 batch->net에 둠 (graph: 묶음을 적용하기 전의 링크 상태). 합친 변경 사항 수를 돌려줌
+// graph_apply_change와 같은 규칙(LINK_DOWN이면 끊김, 아니면 더 싼 비용일 때만 바뀜)으로 링크의 최종 비용을 구하고
+// 처음 비용과 같으면 버림, 끊겼으면 LINK_DOWN, 더 싸졌으면 그 비용, 끊긴 뒤 더 비싼 비용으로 돌아왔으면 LINK_DOWN과 그 비용
+static inline int change_batch_coalesce(ChangeBatch* batch, const Graph* graph) {
+    int cnt = 0;
+    for (int k = 0; k < batch->change_cnt; k++) {
+        const Link* change = &batch->changes[k];
+        if (change->src == change->dst || (change->cost < 0 && change->cost != LINK_DOWN)) {
+            continue; // graph_apply_change가 무시하는 변경 사항
+        }
+        BatchEntry* entry = &batch->entries[cnt++];
+        entry->u = change->src < change->dst ? change->src : change->dst;
+        entry->v = change->src < change->dst ? change->dst : change->src;
+        entry->seq = k;
+    }
+    qsort(batch->entries, cnt, sizeof(BatchEntry), batch_entry_compare);
+
+    batch->net_cnt = 0;
+    for (int first = 0, last; first < cnt; first = last) {
+        int u = batch->entries[first].u, v = batch->entries[first].v;
+        int initial = graph_link_cost(graph, u, v);
+        int cost = initial, moved = 0;
+        for (last = first; last < cnt && batch->entries[last].u == u && batch->entries[last].v == v; last++) {
+            int distance = batch->changes[batch->entries[last].seq].cost;
+            if (distance == LINK_DOWN) {
+                cost = LINK_NONE;
+            } else if (cost > distance) {
+                cost = distance;
+            }
+            moved |= cost != initial;
+        }
+        if (cost == initial) {
+            batch->cancelled += moved;
+        } else if (cost >= LINK_NONE) {
+            change_batch_emit(batch, u, v, LINK_DOWN);
+        } else {
+            if (cost > initial) {
+                change_batch_emit(batch, u, v, LINK_DOWN);
+            }
+            change_batch_emit(batch, u, v, cost);
+        }
+    }
+    return batch->net_cnt;
+}
+
+// 묶었을 때 묶음 수와 없어진 변경 수를 알림
+static inline void change_batch_report(const ChangeBatch* batch) {
+    if (batch_enabled(&batch->opts)) {
+        printf("Batched %lld changes into %d batches (%lld reverted link changes dropped)\n", batch->total, batch->batch_cnt, batch->cancelled);
+    }
+}
+
+#endif
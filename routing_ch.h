@@ -0,0 +1,850 @@
+#ifndef ROUTING_CH_H
+#define ROUTING_CH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "routing_graph.h"
+#include "routing_heap.h"
+#include "routing_table.h"
+#include "routing_timer.h"
+
+// 축약 계층 (contraction hierarchy, -e ch) - 메시지마다 (송신자, 수신자) 최단 경로만 질의
+// 준비: 우선순위(생길 shortcut 수 - 차수 + 이미 축약한 이웃 수)가 가장 낮은 노드부터 하나씩 축약
+//       축약할 노드 v의 두 이웃 a, b 사이에 v를 거치지 않는 같거나 짧은 경로(witness)가 없을 때만 (a, b) shortcut을 둠
+//       witness 탐색은 정한 노드 수까지만 확정하고 멈춤 (못 찾으면 shortcut을 둠 - 많아질 뿐 틀리지 않음)
+//       그러면 최단 경로가 "순위가 올라가는 arc + 내려가는 arc"로 나타나고, 비용으로 가지를 치므로 arc 수가 링크 수에 가깝게 남음
+//       남은 그래프가 조밀해지면(무작위 그래프처럼 계층이 없는 경우) 더 축약하지 않고 나머지를 core로 남김
+// 질의: 양쪽에서 순위가 높아지는 arc로만 힙 탐색. 위쪽 이웃을 거치면 더 짧아지는 노드는 더 펼치지 않고(stall-on-demand)
+//       한쪽의 가장 작은 거리가 지금까지 찾은 경로 비용 이상이면 그쪽 탐색을 멈춤. 닿은 core 노드에서는 core 안을 양방향 다익스트라
+// 비용 변경: shortcut 구조가 비용에 따라 정해지므로 계층을 낡은 것으로 표시하고, 그동안은 그래프에서 양방향 다익스트라로 답함
+//       그 탐색 비용이 축약 한 번의 비용만큼 쌓이면 같은 순서로 다시 축약 (ch_query)
+// 메모리는 arc 수(링크 + shortcut)에 비례
+
+#define CH_ORDER_SETTLE 40      // 우선순위를 계산할 때 witness 탐색에서 확정할 최대 노드 수
+#define CH_ORDER_HOPS 3         // 우선순위를 계산할 때 witness 경로의 최대 링크 수
+#define CH_CONTRACT_SETTLE 100  // 실제로 축약할 때 witness 탐색에서 확정할 최대 노드 수
+#define CH_CONTRACT_HOPS 16     // 실제로 축약할 때 witness 경로의 최대 링크 수
+#define CH_CONTRACT_WORK 50000  // 차수 d인 노드를 축약할 때 witness 탐색마다 WORK / d^2개까지 확정 (위 두 한도 사이로 맞춤)
+#define CH_CORE_DEGREE 12       // 남은 그래프의 평균 차수가 이 값에 닿으면 축약을 멈추고 나머지를 core로 남김
+
+// 축약 중인 그래프의 간선 (남은 노드 사이, 양쪽 목록에 같은 내용으로 둠)
+typedef struct ChEdge_ {
+    int node;
+    int weight;
+    int mid;            // shortcut이면 가운데 노드 (두 끝보다 먼저 축약), 원래 링크면 -1
+} ChEdge;
+
+// 축약할 때만 쓰는 작업 공간
+typedef struct ChContraction_ {
+    ChEdge** edges;     // 노드별 간선 - 축약한 노드의 목록은 그 시점에서 멈추고 곧 그 노드의 위쪽 arc
+    int* edge_cnt;
+    int* edge_cap;
+    int* contracted;
+    int* deleted;       // 이미 축약한 이웃 수
+    int* priority;
+    int* dist;          // witness 탐색 거리 (탐색이 끝나면 지나간 칸만 되돌림)
+    int* hops;          // witness 탐색에서 지난 링크 수
+    int* target;        // 찾을 이웃이면 stamp
+    int stamp;
+    int* touched;
+    int touched_cnt;
+    Heap heap;
+    ChEdge* pending;    // 축약할 노드에서 생길 shortcut (node = 한 끝, mid = 다른 끝)
+    int pending_cap;
+    long long work;     // witness 탐색에서 살펴본 간선 수
+} ChContraction;
+
+typedef struct ContractionHierarchy_ {
+    int node_cnt;
+    int arc_cnt;
+    int shortcut_cnt;
+    int core_rank;      // 이 순위부터는 축약하지 않은 core (core 노드의 arc는 다른 core 노드로의 간선 전부)
+    const Graph* graph; // 다시 축약하거나 그래프를 직접 탐색할 때 읽는 그래프
+    int dirty;          // 축약한 뒤 링크 비용이 바뀌어 계층을 쓸 수 없음
+    long long contract_work; // 마지막 축약에서 witness 탐색이 살펴본 간선 수
+    long long search_work;   // 계층이 낡은 뒤 그래프 탐색이 계층 질의보다 더 살펴본 간선 수
+    long long query_work;    // 계층 질의가 살펴본 arc 수 (질의 하나의 평균을 낼 때 씀)
+    int contract_cnt;   // 통계 (-t): 축약 횟수와 시간, 계층 질의 / 그래프 탐색 수와 시간
+    double contract_time;
+    long long query_cnt;
+    double query_time;
+    long long search_cnt;
+    double search_time;
+    int* rank;          // 노드 -> 축약 순서
+    int* order;         // 순서 -> 노드
+    int* up_offset;     // 노드 v의 위쪽 arc: up_offset[v] ~ up_offset[v + 1] - 1 (머리의 번호 순)
+    int* head;          // arc -> 순위가 높은 끝
+    int* tail;          // arc -> 순위가 낮은 끝
+    int* weight;
+    int* mid;           // shortcut이면 가운데 노드, 원래 링크면 -1
+    int arc_cap;
+    int* fwd_dist;      // 질의 작업 공간 (질의가 끝나면 지나간 칸만 되돌림)
+    int* bwd_dist;
+    int* fwd_arc;
+    int* bwd_arc;
+    int* touched;       // 질의에서 거리를 적은 노드 (양쪽)
+    int touched_cnt;
+    Heap fwd_heap;
+    Heap bwd_heap;
+    int* stack;         // 경로 펼치기 (arc * 2 + 방향)
+    int stack_cap;
+    int* path;          // 마지막 질의의 경로 (송신자부터 수신자까지)
+    int* path_at;       // 노드 -> 경로에서의 위치 (경로를 다듬는 동안만, 그 외에는 -1)
+    int path_cnt;
+    int path_cap;
+    int path_pos;       // ch_view_next가 마지막으로 읽은 위치
+    int path_source;    // 마지막 질의 (없으면 -1)
+    int path_target;
+    int path_dist;
+} ContractionHierarchy;
+
+static inline void ch_stack_push(ContractionHierarchy* ch, int* cnt, int item) {
+    if (*cnt == ch->stack_cap) {
+        ch->stack_cap *= 2;
+        ch->stack = (int*)realloc(ch->stack, sizeof(int) * ch->stack_cap);
+    }
+    ch->stack[(*cnt)++] = item;
+}
+
+static inline void ch_path_push(ContractionHierarchy* ch, int node) {
+    if (ch->path_cnt == ch->path_cap) {
+        ch->path_cap *= 2;
+        ch->path = (int*)realloc(ch->path, sizeof(int) * ch->path_cap);
+    }
+    ch->path[ch->path_cnt++] = node;
+}
+
+// 힙을 비움 (남은 노드의 위치를 되돌림)
+static inline void ch_heap_clear(Heap* heap) {
+    for (int i = 0; i < heap->size; i++) {
+        heap->pos[heap->nodes[i]] = -1;
+    }
+    heap->size = 0;
+}
+
+// 간선 정렬용 (노드 번호 순)
+static inline int ch_edge_compare(const void* a, const void* b) {
+    int x = ((const ChEdge*)a)->node, y = ((const ChEdge*)b)->node;
+    return x < y ? -1 : (x > y);
+}
+
+// ---- 축약 ----
+
+static inline void ch_edge_append(ChContraction* c, int u, int v, int weight, int mid) {
+    if (c->edge_cnt[u] == c->edge_cap[u]) {
+        c->edge_cap[u] = c->edge_cap[u] ? c->edge_cap[u] * 2 : 4;
+        c->edges[u] = (ChEdge*)realloc(c->edges[u], sizeof(ChEdge) * c->edge_cap[u]);
+    }
+    ChEdge* edge = &c->edges[u][c->edge_cnt[u]++];
+    edge->node = v;
+    edge->weight = weight;
+    edge->mid = mid;
+}
+
+// 간선 (u, v)를 넣거나, 이미 있으면 더 짧을 때만 비용과 가운데 노드를 바꿈 (새로 넣었으면 1 반환)
+static inline int ch_edge_add(ChContraction* c, int u, int v, int weight, int mid) {
+    for (int k = 0; k < c->edge_cnt[u]; k++) {
+        if (c->edges[u][k].node != v) {
+            continue;
+        }
+        if (weight < c->edges[u][k].weight) {
+            c->edges[u][k].weight = weight;
+            c->edges[u][k].mid = mid;
+            for (int i = 0; i < c->edge_cnt[v]; i++) {
+                if (c->edges[v][i].node == u) {
+                    c->edges[v][i].weight = weight;
+                    c->edges[v][i].mid = mid;
+                    break;
+                }
+            }
+        }
+        return 0;
+    }
+    ch_edge_append(c, u, v, weight, mid);
+    ch_edge_append(c, v, u, weight, mid);
+    return 1;
+}
+
+static inline void ch_contraction_init(ChContraction* c, const Graph* graph) {
+    int node_cnt = graph->node_cnt;
+    int size = node_cnt > 0 ? node_cnt : 1;
+    c->edges = (ChEdge**)calloc(size, sizeof(ChEdge*));
+    c->edge_cnt = (int*)calloc(size, sizeof(int));
+    c->edge_cap = (int*)calloc(size, sizeof(int));
+    c->contracted = (int*)calloc(size, sizeof(int));
+    c->deleted = (int*)calloc(size, sizeof(int));
+    c->priority = (int*)calloc(size, sizeof(int));
+    c->dist = (int*)malloc(sizeof(int) * size);
+    c->hops = (int*)malloc(sizeof(int) * size);
+    c->target = (int*)calloc(size, sizeof(int));
+    c->stamp = 0;
+    c->touched = (int*)malloc(sizeof(int) * size);
+    c->touched_cnt = 0;
+    for (int v = 0; v < node_cnt; v++) {
+        c->dist[v] = ROUTE_INFINITY;
+    }
+    heap_init(&c->heap, node_cnt);
+    c->heap.key = c->dist;
+    c->pending_cap = 16;
+    c->pending = (ChEdge*)malloc(sizeof(ChEdge) * c->pending_cap);
+    c->work = 0;
+
+    // 양쪽 목록에 한 번씩 들어가도록 각 링크를 번호가 작은 쪽에서 넣음 (자기 자신으로의 링크는 경로에 쓰이지 않음)
+    for (int v = 0; v < node_cnt; v++) {
+        for (int k = graph->offset[v]; k < graph->offset[v] + graph->degree[v]; k++) {
+            int u = graph->adj[k];
+            if (v < u) {
+                ch_edge_append(c, v, u, graph->weight[k], -1);
+                ch_edge_append(c, u, v, graph->weight[k], -1);
+            }
+        }
+    }
+}
+
+// 간선 목록은 ch가 위쪽 arc로 옮겨 간 뒤에 해제
+static inline void ch_contraction_free(ChContraction* c, int node_cnt) {
+    for (int v = 0; v < node_cnt; v++) {
+        free(c->edges[v]);
+    }
+    free(c->edges);
+    free(c->edge_cnt);
+    free(c->edge_cap);
+    free(c->contracted);
+    free(c->deleted);
+    free(c->priority);
+    free(c->dist);
+    free(c->hops);
+    free(c->target);
+    free(c->touched);
+    heap_free(&c->heap);
+    free(c->pending);
+}
+
+// source에서 축약하지 않은 노드로만 다익스트라 - 표시한 target_cnt개의 목표를 모두 확정하거나,
+// bound를 넘는 거리, settle_limit개 확정, hop_limit개보다 많은 링크를 지나는 경로에서 멈춤
+// (멈추면 거리가 실제보다 클 수 있지만 항상 실제 경로의 비용이므로 witness로 써도 틀리지 않음)
+static inline void ch_witness(ChContraction* c, int source, int target_cnt, int bound, int settle_limit, int hop_limit) {
+    c->dist[source] = 0;
+    c->hops[source] = 0;
+    c->touched[c->touched_cnt++] = source;
+    heap_push(&c->heap, source);
+    int settled = 0;
+    while (c->heap.size > 0) {
+        int v = heap_pop(&c->heap);
+        if (c->dist[v] > bound || ++settled > settle_limit) {
+            break;
+        }
+        if (c->target[v] == c->stamp && --target_cnt == 0) {
+            break;
+        }
+        if (c->hops[v] >= hop_limit) {
+            continue;
+        }
+        c->work += c->edge_cnt[v];
+        for (int k = 0; k < c->edge_cnt[v]; k++) {
+            int u = c->edges[v][k].node;
+            if (c->contracted[u]) {
+                continue;
+            }
+            int new_distance = route_add(c->dist[v], c->edges[v][k].weight);
+            if (new_distance < c->dist[u]) {
+                if (c->dist[u] == ROUTE_INFINITY) {
+                    c->touched[c->touched_cnt++] = u;
+                }
+                c->dist[u] = new_distance;
+                c->hops[u] = c->hops[v] + 1;
+                heap_push(&c->heap, u);
+            }
+        }
+    }
+    ch_heap_clear(&c->heap);
+}
+
+static inline void ch_witness_reset(ChContraction* c) {
+    for (int i = 0; i < c->touched_cnt; i++) {
+        c->dist[c->touched[i]] = ROUTE_INFINITY;
+    }
+    c->touched_cnt = 0;
+}
+
+// v를 축약하면 생길 shortcut을 c->pending에 모음 (개수 반환) - witness가 (이웃 a, b) 경로보다 길 때만
+static inline int ch_collect_shortcuts(ChContraction* c, int v, int settle_limit, int hop_limit) {
+    int cnt = 0, max_weight = 0;
+    const ChEdge* edges = c->edges[v];
+    for (int i = 0; i < c->edge_cnt[v]; i++) {
+        if (edges[i].weight > max_weight) {
+            max_weight = edges[i].weight;
+        }
+    }
+    c->contracted[v] = 1;
+    for (int i = 0; i + 1 < c->edge_cnt[v]; i++) {
+        int a = edges[i].node;
+        c->stamp++;
+        for (int j = i + 1; j < c->edge_cnt[v]; j++) {
+            c->target[edges[j].node] = c->stamp;
+        }
+        ch_witness(c, a, c->edge_cnt[v] - i - 1, route_add(edges[i].weight, max_weight), settle_limit, hop_limit);
+        for (int j = i + 1; j < c->edge_cnt[v]; j++) {
+            int via = route_add(edges[i].weight, edges[j].weight);
+            if (c->dist[edges[j].node] <= via) {
+                continue;
+            }
+            if (cnt == c->pending_cap) {
+                c->pending_cap *= 2;
+                c->pending = (ChEdge*)realloc(c->pending, sizeof(ChEdge) * c->pending_cap);
+            }
+            c->pending[cnt].node = a;
+            c->pending[cnt].mid = edges[j].node;
+            c->pending[cnt].weight = via;
+            cnt++;
+        }
+        ch_witness_reset(c);
+    }
+    c->contracted[v] = 0;
+    return cnt;
+}
+
+static inline int ch_priority(ChContraction* c, int v) {
+    return ch_collect_shortcuts(c, v, CH_ORDER_SETTLE, CH_ORDER_HOPS) - c->edge_cnt[v] + c->deleted[v];
+}
+
+// v를 축약 - 이웃 목록에서 v를 빼고 shortcut을 넣음 (v의 목록은 그대로 남아 위쪽 arc가 됨)
+// 남은 그래프의 간선 수 변화를 반환
+static inline int ch_contract_node(ChContraction* c, int v) {
+    long long deg = c->edge_cnt[v] > 0 ? c->edge_cnt[v] : 1;
+    long long settle = CH_CONTRACT_WORK / (deg * deg);
+    int cnt = ch_collect_shortcuts(c, v, settle > CH_CONTRACT_SETTLE ? CH_CONTRACT_SETTLE : settle < CH_ORDER_SETTLE ? CH_ORDER_SETTLE : (int)settle, CH_CONTRACT_HOPS);
+    c->contracted[v] = 1;
+    for (int i = 0; i < c->edge_cnt[v]; i++) {
+        int a = c->edges[v][i].node;
+        for (int k = 0; k < c->edge_cnt[a]; k++) {
+            if (c->edges[a][k].node == v) {
+                c->edges[a][k] = c->edges[a][--c->edge_cnt[a]];
+                break;
+            }
+        }
+        c->deleted[a]++;
+    }
+    int added = 0;
+    for (int k = 0; k < cnt; k++) {
+        added += ch_edge_add(c, c->pending[k].node, c->pending[k].mid, c->pending[k].weight, v);
+    }
+    return added - c->edge_cnt[v];
+}
+
+// 그래프를 축약해 위쪽 arc를 만듦 - reorder면 우선순위로 순서를 새로 정하고, 아니면 ch->order 순서를 그대로 씀
+// 남은 그래프의 평균 차수가 CH_CORE_DEGREE에 닿으면 (witness 탐색 비용과 shortcut이 급격히 늘어나는 지점) 나머지는 core로 남김
+static inline void ch_contract(ContractionHierarchy* ch, const Graph* graph, int reorder) {
+    double start = phase_timer.enabled ? timer_now() : 0;
+    int node_cnt = graph->node_cnt;
+    ChContraction c;
+    ch_contraction_init(&c, graph);
+
+    if (reorder) {
+        // 우선순위는 lazy하게 고침 - 꺼낸 노드의 우선순위를 다시 계산해 다음 노드보다 높아졌으면 다시 넣음
+        Heap queue;
+        heap_init(&queue, node_cnt);
+        queue.key = c.priority;
+        long long edge_sum = 0; // 남은 그래프의 간선 수 (양쪽 목록에 하나씩)
+        for (int v = 0; v < node_cnt; v++) {
+            c.priority[v] = ch_priority(&c, v);
+            heap_push(&queue, v);
+            edge_sum += c.edge_cnt[v];
+        }
+        int r = 0;
+        while (queue.size > 0 && edge_sum < (long long)CH_CORE_DEGREE * queue.size) {
+            int v = heap_pop(&queue);
+            c.priority[v] = ch_priority(&c, v);
+            if (queue.size > 0 && heap_less(&queue, queue.nodes[0], v)) {
+                heap_push(&queue, v);
+                continue;
+            }
+            ch->rank[v] = r;
+            ch->order[r++] = v;
+            edge_sum += 2 * ch_contract_node(&c, v);
+            for (int i = 0; i < c.edge_cnt[v]; i++) {
+                int a = c.edges[v][i].node;
+                c.priority[a]++;
+                heap_update(&queue, a);
+            }
+        }
+        ch->core_rank = r;
+        while (queue.size > 0) {
+            int v = heap_pop(&queue);
+            ch->rank[v] = r;
+            ch->order[r++] = v;
+        }
+        heap_free(&queue);
+    } else {
+        for (int r = 0; r < ch->core_rank; r++) {
+            ch_contract_node(&c, ch->order[r]);
+        }
+    }
+
+    // 위쪽 arc (노드 번호 순으로 구간, 구간 안은 머리의 번호 순)
+    ch->up_offset[0] = 0;
+    for (int v = 0; v < node_cnt; v++) {
+        ch->up_offset[v + 1] = ch->up_offset[v] + c.edge_cnt[v];
+    }
+    int arc_cnt = ch->arc_cnt = ch->up_offset[node_cnt];
+    if (arc_cnt > ch->arc_cap) {
+        ch->arc_cap = arc_cnt;
+        ch->head = (int*)realloc(ch->head, sizeof(int) * arc_cnt);
+        ch->tail = (int*)realloc(ch->tail, sizeof(int) * arc_cnt);
+        ch->weight = (int*)realloc(ch->weight, sizeof(int) * arc_cnt);
+        ch->mid = (int*)realloc(ch->mid, sizeof(int) * arc_cnt);
+    }
+    ch->shortcut_cnt = 0;
+    for (int v = 0; v < node_cnt; v++) {
+        qsort(c.edges[v], c.edge_cnt[v], sizeof(ChEdge), ch_edge_compare);
+        for (int k = 0; k < c.edge_cnt[v]; k++) {
+            int arc = ch->up_offset[v] + k;
+            ch->head[arc] = c.edges[v][k].node;
+            ch->tail[arc] = v;
+            ch->weight[arc] = c.edges[v][k].weight;
+            ch->mid[arc] = c.edges[v][k].mid;
+            ch->shortcut_cnt += ch->mid[arc] >= 0;
+        }
+    }
+    ch->contract_work = c.work;
+    ch_contraction_free(&c, node_cnt);
+    ch->dirty = 0;
+    ch->search_work = 0;
+    ch->contract_cnt++;
+    if (phase_timer.enabled) {
+        ch->contract_time += timer_now() - start;
+    }
+}
+
+// 그래프로 계층 준비 (순서를 정하며 축약)
+static inline void ch_build(ContractionHierarchy* ch, const Graph* graph) {
+    int node_cnt = graph->node_cnt;
+    int size = node_cnt > 0 ? node_cnt : 1;
+    ch->node_cnt = node_cnt;
+    ch->graph = graph;
+    ch->rank = (int*)malloc(sizeof(int) * size);
+    ch->order = (int*)malloc(sizeof(int) * size);
+    ch->up_offset = (int*)malloc(sizeof(int) * (node_cnt + 1));
+    ch->head = ch->tail = ch->weight = ch->mid = NULL;
+    ch->arc_cap = 0;
+    ch->contract_cnt = 0;
+    ch->contract_time = ch->query_time = ch->search_time = 0;
+    ch->query_cnt = ch->search_cnt = 0;
+    ch->query_work = 0;
+    ch_contract(ch, graph, 1);
+
+    ch->fwd_dist = (int*)malloc(sizeof(int) * size);
+    ch->bwd_dist = (int*)malloc(sizeof(int) * size);
+    ch->fwd_arc = (int*)malloc(sizeof(int) * size);
+    ch->bwd_arc = (int*)malloc(sizeof(int) * size);
+    ch->touched = (int*)malloc(sizeof(int) * size);
+    ch->touched_cnt = 0;
+    ch->path_at = (int*)malloc(sizeof(int) * size);
+    for (int v = 0; v < node_cnt; v++) {
+        ch->fwd_dist[v] = ch->bwd_dist[v] = ROUTE_INFINITY;
+        ch->fwd_arc[v] = ch->bwd_arc[v] = -1;
+        ch->path_at[v] = -1;
+    }
+    heap_init(&ch->fwd_heap, node_cnt);
+    ch->fwd_heap.key = ch->fwd_dist;
+    heap_init(&ch->bwd_heap, node_cnt);
+    ch->bwd_heap.key = ch->bwd_dist;
+    ch->stack_cap = 64;
+    ch->stack = (int*)malloc(sizeof(int) * ch->stack_cap);
+    ch->path_cap = 64;
+    ch->path = (int*)malloc(sizeof(int) * ch->path_cap);
+    ch->path_cnt = ch->path_pos = 0;
+    ch->path_source = ch->path_target = -1;
+    ch->path_dist = ROUTE_INFINITY;
+}
+
+static inline void ch_free(ContractionHierarchy* ch) {
+    free(ch->rank);
+    free(ch->order);
+    free(ch->up_offset);
+    free(ch->head);
+    free(ch->tail);
+    free(ch->weight);
+    free(ch->mid);
+    free(ch->fwd_dist);
+    free(ch->bwd_dist);
+    free(ch->fwd_arc);
+    free(ch->bwd_arc);
+    free(ch->touched);
+    heap_free(&ch->fwd_heap);
+    heap_free(&ch->bwd_heap);
+    free(ch->stack);
+    free(ch->path);
+    free(ch->path_at);
+    memset(ch, 0, sizeof(*ch));
+}
+
+// 그래프의 링크가 바뀌었음을 알림 - 계층을 낡은 것으로 표시만 함 (다시 축약할지는 ch_query가 정함)
+static inline void ch_mark_stale(ContractionHierarchy* ch, const Graph* graph) {
+    ch->graph = graph;
+    ch->dirty = 1;
+}
+
+// 마지막 질의의 경로를 버림 - 변경 묶음을 모두 알린 뒤 부름 (비용이 바뀌었을 수 있음)
+static inline void ch_forget_last_query(ContractionHierarchy* ch) {
+    ch->path_source = ch->path_target = -1;
+}
+
+// v의 위쪽 arc 중 머리가 u인 arc (없으면 -1) - 머리의 번호 순으로 이진 탐색
+static inline int ch_up_arc(const ContractionHierarchy* ch, int v, int u) {
+    int low = ch->up_offset[v], high = ch->up_offset[v + 1] - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        if (ch->head[mid] == u) {
+            return mid;
+        }
+        if (ch->head[mid] < u) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return -1;
+}
+
+// 한쪽 탐색에서 v를 확정하고 위쪽 arc를 완화 (core 노드는 라벨만 적고 힙에 넣지 않음 - core 탐색의 시작점)
+// 위쪽 이웃 u를 거쳐 내려오는 편이 더 짧으면 v까지의 거리가 최단이 아니므로 펼치지 않음 (stall-on-demand)
+static inline void ch_settle(ContractionHierarchy* ch, int v, int* dist, int* via, Heap* heap) {
+    int begin = ch->up_offset[v], end = ch->up_offset[v + 1];
+    ch->query_work += end - begin;
+    for (int arc = begin; arc < end; arc++) {
+        if (route_add(dist[ch->head[arc]], ch->weight[arc]) < dist[v]) {
+            return;
+        }
+    }
+    for (int arc = begin; arc < end; arc++) {
+        int u = ch->head[arc];
+        int new_distance = route_add(dist[v], ch->weight[arc]);
+        if (new_distance < dist[u]) {
+            if (ch->fwd_dist[u] == ROUTE_INFINITY && ch->bwd_dist[u] == ROUTE_INFINITY) {
+                ch->touched[ch->touched_cnt++] = u;
+            }
+            dist[u] = new_distance;
+            via[u] = arc;
+            if (ch->rank[u] < ch->core_rank) {
+                heap_push(heap, u);
+            }
+        }
+    }
+}
+
+// 양방향 다익스트라에서 u의 라벨을 distance로 낮춤 - 반대쪽 라벨도 있으면 u에서 만나는 경로를 봄
+static inline void ch_label(ContractionHierarchy* ch, int u, int distance, int* dist, int* via, int item, Heap* heap, int* best, int* meet) {
+    if (ch->fwd_dist[u] == ROUTE_INFINITY && ch->bwd_dist[u] == ROUTE_INFINITY) {
+        ch->touched[ch->touched_cnt++] = u;
+    }
+    dist[u] = distance;
+    via[u] = item;
+    heap_push(heap, u);
+    int total = route_add(ch->fwd_dist[u], ch->bwd_dist[u]);
+    if (total < *best) {
+        *best = total;
+        *meet = u;
+    }
+}
+
+// arc들을 펼쳐 경로 뒤에 붙임 (stack[0 ~ cnt - 1]을 뒤에서부터, 방향 0은 tail -> head, 1은 head -> tail)
+static inline void ch_unpack(ContractionHierarchy* ch, int cnt) {
+    while (cnt > 0) {
+        int item = ch->stack[--cnt];
+        int arc = item / 2, backward = item % 2;
+        int w = ch->mid[arc];
+        if (w < 0) {
+            ch_path_push(ch, backward ? ch->tail[arc] : ch->head[arc]);
+            continue;
+        }
+        // (w, tail)과 (w, head)는 둘 다 w의 위쪽 arc
+        int low = ch_up_arc(ch, w, ch->tail[arc]), high = ch_up_arc(ch, w, ch->head[arc]);
+        if (!backward) {
+            // tail -> w -> head
+            ch_stack_push(ch, &cnt, high * 2);
+            ch_stack_push(ch, &cnt, low * 2 + 1);
+        } else {
+            // head -> w -> tail
+            ch_stack_push(ch, &cnt, low * 2);
+            ch_stack_push(ch, &cnt, high * 2 + 1);
+        }
+    }
+}
+
+// 비용 0인 링크가 있으면 펼친 경로에 같은 노드가 두 번 나올 수 있음 (비용 0인 고리) - 고리를 잘라 냄
+static inline void ch_path_simplify(ContractionHierarchy* ch) {
+    int cnt = 0;
+    for (int i = 0; i < ch->path_cnt; i++) {
+        int v = ch->path[i];
+        if (ch->path_at[v] >= 0) {
+            for (int j = ch->path_at[v] + 1; j < cnt; j++) {
+                ch->path_at[ch->path[j]] = -1;
+            }
+            cnt = ch->path_at[v] + 1;
+            continue;
+        }
+        ch->path_at[v] = cnt;
+        ch->path[cnt++] = v;
+    }
+    for (int i = 0; i < cnt; i++) {
+        ch->path_at[ch->path[i]] = -1;
+    }
+    ch->path_cnt = cnt;
+}
+
+// 계층 질의 - 양쪽에서 위쪽 arc로 core 밖을 탐색한 뒤, 라벨이 붙은 core 노드에서 core 안을 양방향 다익스트라
+// 만난 경로를 펼쳐 ch->path 뒤에 붙임
+static inline int ch_upward_search(ContractionHierarchy* ch, int source, int target) {
+    // 거리가 작은 쪽부터 한 노드씩 확정 - 확정할 때 반대쪽 거리도 있으면 그 노드에서 만나는 경로
+    // (위로만 가는 탐색이라 한쪽이 멈춰도 다른 쪽은 계속해야 함 - 각자 가장 작은 거리가 찾은 비용 이상일 때 멈춤)
+    int best = ROUTE_INFINITY, meet = -1;
+    ch->fwd_dist[source] = 0;
+    ch->bwd_dist[target] = 0;
+    ch->touched[ch->touched_cnt++] = source;
+    ch->touched[ch->touched_cnt++] = target;
+    if (ch->rank[source] < ch->core_rank) {
+        heap_push(&ch->fwd_heap, source);
+    }
+    if (ch->rank[target] < ch->core_rank) {
+        heap_push(&ch->bwd_heap, target);
+    }
+    while (ch->fwd_heap.size > 0 || ch->bwd_heap.size > 0) {
+        int forward = ch->bwd_heap.size == 0 ||
+                      (ch->fwd_heap.size > 0 && ch->fwd_dist[ch->fwd_heap.nodes[0]] <= ch->bwd_dist[ch->bwd_heap.nodes[0]]);
+        Heap* heap = forward ? &ch->fwd_heap : &ch->bwd_heap;
+        int* dist = forward ? ch->fwd_dist : ch->bwd_dist;
+        int v = heap_pop(heap);
+        if (dist[v] >= best) {
+            ch_heap_clear(heap); // 이 쪽에서는 더 짧은 경로가 나올 수 없음
+            continue;
+        }
+        int total = route_add(ch->fwd_dist[v], ch->bwd_dist[v]);
+        if (total < best) {
+            best = total;
+            meet = v;
+        }
+        if (forward) {
+            ch_settle(ch, v, ch->fwd_dist, ch->fwd_arc, heap);
+        } else {
+            ch_settle(ch, v, ch->bwd_dist, ch->bwd_arc, heap);
+        }
+    }
+
+    // core 안은 양쪽이 같은 간선을 쓰므로 두 쪽의 가장 작은 거리 합이 찾은 비용 이상이면 멈춰도 됨
+    int seed_cnt = ch->touched_cnt;
+    for (int i = 0; i < seed_cnt; i++) {
+        int v = ch->touched[i];
+        if (ch->rank[v] < ch->core_rank) {
+            continue;
+        }
+        if (ch->fwd_dist[v] < best) {
+            heap_push(&ch->fwd_heap, v);
+        }
+        if (ch->bwd_dist[v] < best) {
+            heap_push(&ch->bwd_heap, v);
+        }
+        int total = route_add(ch->fwd_dist[v], ch->bwd_dist[v]);
+        if (total < best) {
+            best = total;
+            meet = v;
+        }
+    }
+    while (ch->fwd_heap.size > 0 && ch->bwd_heap.size > 0) {
+        int fwd_min = ch->fwd_dist[ch->fwd_heap.nodes[0]], bwd_min = ch->bwd_dist[ch->bwd_heap.nodes[0]];
+        if (route_add(fwd_min, bwd_min) >= best) {
+            break;
+        }
+        int forward = fwd_min <= bwd_min;
+        Heap* heap = forward ? &ch->fwd_heap : &ch->bwd_heap;
+        int* dist = forward ? ch->fwd_dist : ch->bwd_dist;
+        int* via = forward ? ch->fwd_arc : ch->bwd_arc;
+        int v = heap_pop(heap);
+        ch->query_work += ch->up_offset[v + 1] - ch->up_offset[v];
+        for (int arc = ch->up_offset[v]; arc < ch->up_offset[v + 1]; arc++) {
+            int new_distance = route_add(dist[v], ch->weight[arc]);
+            if (new_distance < dist[ch->head[arc]]) {
+                ch_label(ch, ch->head[arc], new_distance, dist, via, arc, heap, &best, &meet);
+            }
+        }
+    }
+    ch_heap_clear(&ch->fwd_heap);
+    ch_heap_clear(&ch->bwd_heap);
+
+    if (meet >= 0) {
+        // 송신자 쪽 arc는 meet에서 거꾸로 모았다가 뒤집어서 펼치고, 수신자 쪽은 meet에서 내려가며 펼침
+        int cnt = 0;
+        for (int v = meet; v != target; v = ch->tail[ch->bwd_arc[v]]) {
+            ch_stack_push(ch, &cnt, ch->bwd_arc[v] * 2 + 1);
+        }
+        for (int i = 0, j = cnt - 1; i < j; i++, j--) {
+            int swap = ch->stack[i];
+            ch->stack[i] = ch->stack[j];
+            ch->stack[j] = swap;
+        }
+        for (int v = meet; v != source; v = ch->tail[ch->fwd_arc[v]]) {
+            ch_stack_push(ch, &cnt, ch->fwd_arc[v] * 2);
+        }
+        ch_unpack(ch, cnt);
+    }
+    return best;
+}
+
+// 계층이 낡았을 때의 질의 - 그래프에서 양방향 다익스트라 (fwd_arc, bwd_arc에는 앞 노드를 적음)
+// 라벨이 바뀔 때마다 그 노드에서 만나는 경로를 보고, 두 쪽의 가장 작은 거리 합이 찾은 경로 비용 이상이면 멈춤
+static inline int ch_search(ContractionHierarchy* ch, int source, int target) {
+    const Graph* graph = ch->graph;
+    int best = ROUTE_INFINITY, meet = -1;
+    long long work = 0;
+    ch->fwd_dist[source] = 0;
+    ch->bwd_dist[target] = 0;
+    ch->touched[ch->touched_cnt++] = source;
+    ch->touched[ch->touched_cnt++] = target;
+    heap_push(&ch->fwd_heap, source);
+    heap_push(&ch->bwd_heap, target);
+    while (ch->fwd_heap.size > 0 && ch->bwd_heap.size > 0) {
+        int fwd_min = ch->fwd_dist[ch->fwd_heap.nodes[0]], bwd_min = ch->bwd_dist[ch->bwd_heap.nodes[0]];
+        if (route_add(fwd_min, bwd_min) >= best) {
+            break;
+        }
+        int forward = fwd_min <= bwd_min;
+        Heap* heap = forward ? &ch->fwd_heap : &ch->bwd_heap;
+        int* dist = forward ? ch->fwd_dist : ch->bwd_dist;
+        int* via = forward ? ch->fwd_arc : ch->bwd_arc;
+        int v = heap_pop(heap);
+        int begin = graph->offset[v], end = begin + graph->degree[v];
+        work += graph->degree[v];
+        for (int k = begin; k < end; k++) {
+            int new_distance = route_add(dist[v], graph->weight[k]);
+            if (new_distance < dist[graph->adj[k]]) {
+                ch_label(ch, graph->adj[k], new_distance, dist, via, v, heap, &best, &meet);
+            }
+        }
+    }
+    ch_heap_clear(&ch->fwd_heap);
+    ch_heap_clear(&ch->bwd_heap);
+    // 계층이 있었다면 아꼈을 만큼만 쌓음 (계층 질의가 그래프 탐색보다 나을 것이 없는 그래프에서는 다시 축약하지 않음)
+    if (ch->query_cnt > 0) {
+        work -= ch->query_work / ch->query_cnt;
+    }
+    if (work > 0) {
+        ch->search_work += work;
+    }
+
+    if (meet >= 0) {
+        // 송신자 쪽은 meet에서 거꾸로 모았다가 뒤집어 붙이고, 수신자 쪽은 meet에서 따라감
+        int cnt = 0;
+        for (int v = meet; v != source; v = ch->fwd_arc[v]) {
+            ch_stack_push(ch, &cnt, v);
+        }
+        while (cnt > 0) {
+            ch_path_push(ch, ch->stack[--cnt]);
+        }
+        for (int v = meet; v != target; ) {
+            v = ch->bwd_arc[v];
+            ch_path_push(ch, v);
+        }
+    }
+    return best;
+}
+
+// source에서 target까지의 최단 거리 (도달 불가면 ROUTE_INFINITY), 경로는 ch->path에 남김
+// 계층이 낡았으면 그래프 탐색으로 답하다가, 그 탐색이 계층 질의보다 더 살펴본 간선 수가 마지막 축약의 witness 탐색만큼 쌓이면
+// 같은 순서로 다시 축약 (다음 변경이 언제 올지 모르는 채로 탐색 비용을 쌓는 ski rental - 어느 쪽으로 끝나도 최선의 두 배 안쪽,
+// 변경이 잦고 질의가 적으면 축약하지 않고, 변경 뒤 질의가 많으면 곧 축약함)
+static inline int ch_query(ContractionHierarchy* ch, int source, int target) {
+    if (ch->path_source == source && ch->path_target == target) {
+        ch->path_pos = 0;
+        return ch->path_dist;
+    }
+    ch->path_source = source;
+    ch->path_target = target;
+    ch->path_cnt = ch->path_pos = 0;
+    ch_path_push(ch, source);
+    if (source == target) {
+        ch->path_dist = 0;
+        return 0;
+    }
+    if (ch->dirty && ch->search_work >= ch->contract_work) {
+        ch_contract(ch, ch->graph, 0);
+    }
+
+    double start = phase_timer.enabled ? timer_now() : 0;
+    int best;
+    if (ch->dirty) {
+        best = ch_search(ch, source, target);
+        ch->search_cnt++;
+    } else {
+        best = ch_upward_search(ch, source, target);
+        ch->query_cnt++;
+    }
+    ch_path_simplify(ch);
+
+    // 지나간 칸만 되돌림
+    for (int i = 0; i < ch->touched_cnt; i++) {
+        int v = ch->touched[i];
+        ch->fwd_dist[v] = ch->bwd_dist[v] = ROUTE_INFINITY;
+        ch->fwd_arc[v] = ch->bwd_arc[v] = -1;
+    }
+    ch->touched_cnt = 0;
+    if (phase_timer.enabled) {
+        *(ch->dirty ? &ch->search_time : &ch->query_time) += timer_now() - start;
+    }
+    ch->path_dist = best;
+    return best;
+}
+
+// 메시지 엔진이 읽는 라우팅 정보 - dist는 질의 한 번, next는 마지막 질의 경로를 따라가며 답함
+// (경로 밖의 칸을 물으면 그 칸으로 다시 질의)
+static inline uint32_t ch_view_dist(void* ctx, int from, int to) {
+    int distance = ch_query((ContractionHierarchy*)ctx, from, to);
+    return distance < ROUTE_INFINITY ? (uint32_t)distance : ROUTE_NONE;
+}
+
+static inline uint32_t ch_view_next(void* ctx, int from, int to) {
+    ContractionHierarchy* ch = (ContractionHierarchy*)ctx;
+    if (from == to) {
+        return (uint32_t)to;
+    }
+    if (ch->path_target != to || ch->path_pos >= ch->path_cnt || ch->path[ch->path_pos] != from) {
+        ch->path_pos = ch->path_cnt;
+        if (ch->path_target == to) {
+            for (int i = 0; i < ch->path_cnt; i++) {
+                if (ch->path[i] == from) {
+                    ch->path_pos = i;
+                    break;
+                }
+            }
+        }
+        if (ch->path_pos >= ch->path_cnt) {
+            ch_query(ch, from, to);
+        }
+    }
+    if (ch->path_pos + 1 >= ch->path_cnt) {
+        return ROUTE_NONE;
+    }
+    return (uint32_t)ch->path[++ch->path_pos];
+}
+
+// -t일 때 계층 크기와 축약 / 계층 질의 / 그래프 탐색의 횟수와 시간을 stderr에 알림 (bench/routing_bench가 읽음)
+static inline void ch_report(const ContractionHierarchy* ch) {
+    if (!phase_timer.enabled) {
+        return;
+    }
+    fprintf(stderr, "ch arcs %d shortcuts %d core %d\n", ch->arc_cnt, ch->shortcut_cnt, ch->node_cnt - ch->core_rank);
+    fprintf(stderr, "ch contract %d %.9f\n", ch->contract_cnt, ch->contract_time);
+    fprintf(stderr, "ch query %lld %.9f\n", ch->query_cnt, ch->query_time);
+    fprintf(stderr, "ch search %lld %.9f\n", ch->search_cnt, ch->search_time);
+}
+
+static inline RouteView ch_route_view(ContractionHierarchy* ch) {
+    RouteView view;
+    view.node_cnt = ch->node_cnt;
+    view.dist = ch_view_dist;
+    view.next = ch_view_next;
+    view.ctx = ch;
+    return view;
+}
+
+#endif
@@ -0,0 +1,504 @@
+#ifndef ROUTING_DAEMON_H
+#define ROUTING_DAEMON_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "routing_input.h"
+#include "routing_table.h"
+
+// 데몬 모드 (-D 소켓) - 토폴로지를 한 번만 읽고 Unix 소켓으로 변경 사항과 경로 질의를 받음
+// 질의는 변경되지 않는 라우팅 테이블 스냅샷에서 답하고, 재계산은 백그라운드 스레드가 맡아
+// 새 스냅샷을 포인터 교체 한 번으로 게시 (RCU) - 질의 쪽은 락을 잡지 않고 재계산을 기다리지도 않음
+// 교체된 스냅샷은 그것을 읽던 연결이 모두 질의를 끝낸 뒤(유예 기간) 다음 게시에 다시 씀
+//
+// 프로토콜 - 한 줄에 명령 하나, 명령마다 한 줄로 응답
+//   route S D       "다음홉 거리" 또는 "unreachable"
+//   path S D        "cost 거리 hops S ... " 또는 "unreachable"
+//   change S D C    "ok N" (N: 지금까지 받은 변경 사항 수, 변경 파일 한 줄과 같은 규칙으로 적용)
+//   sync            지금까지 받은 변경 사항이 모두 반영된 스냅샷이 게시될 때까지 기다린 뒤 "version N"
+//   version         "version N" (지금 스냅샷에 반영된 변경 사항 수)
+//   shutdown        "bye" 후 데몬 종료
+// 재계산 중에 들어온 변경 사항들은 모아 두었다가 한꺼번에 적용하고 한 번만 계산함
+// 스냅샷에서 시작하면 그 테이블과 변경 사항 수(version)에서 이어 가고, 끝낼 때 지금까지의 상태를 저장할 수 있음
+
+#define DAEMON_MAX_CLIENTS 64   // 동시에 연결할 수 있는 클라이언트 수
+#define DAEMON_READ_BUF 65536   // 연결마다의 읽기 버퍼 (한 줄이 이보다 길면 오류)
+
+// 엔진이 데몬에 넘겨주는 함수들 (백그라운드 스레드에서만 호출)
+typedef struct DaemonEngine_ {
+    void* ctx;
+    void (*apply)(void* ctx, int source, int destination, int distance);    // 변경 사항 하나 적용
+    void (*compute)(void* ctx, int change, RouteTable* table);              // 지금 상태로 table 계산
+    void (*save)(void* ctx, const Link* changes, int change_cnt, const RouteTable* table); // 끝낼 때 상태 저장 (NULL이면 저장 안 함)
+    const RouteTable* initial;  // 처음 테이블 (NULL이면 compute로 계산)
+    const Link* history;        // initial에 이미 반영된 변경 사항들
+    int history_cnt;
+} DaemonEngine;
+
+typedef struct DaemonSnapshot_ {
+    RouteTable table;
+    long long version;  // 반영된 변경 사항 수
+} DaemonSnapshot;
+
+typedef struct Daemon_ Daemon;
+
+// 연결 하나 - epoch가 0이 아니면 그 epoch 이후에 게시된 스냅샷을 읽는 중
+// (연결마다 캐시 라인을 따로 쓰도록 채움)
+typedef struct DaemonClient_ {
+    uint64_t epoch;
+    int fd;
+    int used;
+    Daemon* daemon;
+    char pad[40];
+} DaemonClient;
+
+// 응답 버퍼
+typedef struct DaemonBuf_ {
+    char* data;
+    size_t len;
+    size_t cap;
+} DaemonBuf;
+
+struct Daemon_ {
+    const DaemonEngine* engine;
+    int node_cnt;
+    int listen_fd;
+    DaemonSnapshot* current;    // 질의가 읽는 스냅샷 (원자적으로 교체)
+    DaemonSnapshot* spare;      // 다음 게시에 채울 스냅샷
+    DaemonSnapshot snapshots[2];
+    uint64_t epoch;             // 게시할 때마다 증가 (1부터)
+    RouteTable work;            // 재계산용 테이블 (백그라운드 스레드만 사용)
+    pthread_t writer;
+    pthread_mutex_t lock;       // 아래 변경 사항 대기열과 연결 목록을 보호 (질의는 잡지 않음)
+    pthread_cond_t changed;     // 대기열에 변경 사항이 들어옴
+    pthread_cond_t published;   // 새 스냅샷이 게시됨, 연결이 끝남
+    Link* pending;
+    int pending_cnt;
+    int pending_cap;
+    long long accepted;         // 받은 변경 사항 수
+    long long applied;          // 게시된 스냅샷에 반영된 변경 사항 수
+    Link* log;                  // 처음 토폴로지 이후 적용한 변경 사항 전체 (백그라운드 스레드만 사용)
+    int log_cnt;
+    int log_cap;
+    int stop;
+    int active;                 // 열려 있는 연결 수
+    DaemonClient clients[DAEMON_MAX_CLIENTS];
+};
+
+static inline void daemon_buf_reserve(DaemonBuf* buf, size_t extra) {
+    if (buf->len + extra > buf->cap) {
+        while (buf->len + extra > buf->cap) {
+            buf->cap = buf->cap ? buf->cap * 2 : 4096;
+        }
+        buf->data = (char*)realloc(buf->data, buf->cap);
+    }
+}
+
+static inline void daemon_buf_text(DaemonBuf* buf, const char* text) {
+    size_t len = strlen(text);
+    daemon_buf_reserve(buf, len);
+    memcpy(buf->data + buf->len, text, len);
+    buf->len += len;
+}
+
+static inline void daemon_buf_number(DaemonBuf* buf, long long value, char end) {
+    daemon_buf_reserve(buf, 24);
+    buf->len += (size_t)snprintf(buf->data + buf->len, 24, "%lld%c", value, end);
+}
+
+// 버퍼 내용을 모두 보냄 (상대가 연결을 끊었으면 0)
+static inline int daemon_buf_send(DaemonBuf* buf, int fd) {
+    size_t sent = 0;
+    while (sent < buf->len) {
+        ssize_t n = send(fd, buf->data + sent, buf->len - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            buf->len = 0;
+            return 0;
+        }
+        sent += (size_t)n;
+    }
+    buf->len = 0;
+    return 1;
+}
+
+// 질의 시작 - 지금 게시된 스냅샷을 얻음 (epoch를 먼저 알린 뒤 포인터를 읽으므로 게시하는 쪽이 기다려 줌)
+static inline const DaemonSnapshot* daemon_read_begin(Daemon* daemon, DaemonClient* client) {
+    __atomic_store_n(&client->epoch, __atomic_load_n(&daemon->epoch, __ATOMIC_SEQ_CST), __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&daemon->current, __ATOMIC_SEQ_CST);
+}
+
+static inline void daemon_read_end(DaemonClient* client) {
+    __atomic_store_n(&client->epoch, 0, __ATOMIC_RELEASE);
+}
+
+// 새 스냅샷 게시 - work를 예비 스냅샷에 복사해 교체하고, 이전 스냅샷을 읽던 질의가 끝나면 예비로 돌림
+static inline void daemon_publish(Daemon* daemon, long long version) {
+    DaemonSnapshot* snapshot = daemon->spare;
+    route_table_copy(&snapshot->table, &daemon->work);
+    snapshot->version = version;
+    DaemonSnapshot* old = __atomic_exchange_n(&daemon->current, snapshot, __ATOMIC_SEQ_CST);
+    uint64_t epoch = __atomic_add_fetch(&daemon->epoch, 1, __ATOMIC_SEQ_CST);
+    for (int c = 0; c < DAEMON_MAX_CLIENTS; c++) {
+        uint64_t reading;
+        while ((reading = __atomic_load_n(&daemon->clients[c].epoch, __ATOMIC_SEQ_CST)) != 0 && reading < epoch) {
+            sched_yield();
+        }
+    }
+    daemon->spare = old;
+}
+
+// 백그라운드 재계산 스레드 - 쌓인 변경 사항을 모두 적용하고 한 번 계산해 게시
+static void* daemon_writer(void* arg) {
+    Daemon* daemon = (Daemon*)arg;
+    Link* batch = NULL;
+    int batch_cap = 0;
+
+    pthread_mutex_lock(&daemon->lock);
+    for (;;) {
+        while (daemon->pending_cnt == 0 && !daemon->stop) {
+            pthread_cond_wait(&daemon->changed, &daemon->lock);
+        }
+        if (daemon->stop) {
+            break;
+        }
+        // 대기열과 batch를 바꿔서 락 밖에서 처리 (그동안 들어오는 변경 사항은 비운 대기열에 쌓임)
+        Link* changes = daemon->pending;
+        int change_cnt = daemon->pending_cnt;
+        int change_cap = daemon->pending_cap;
+        long long version = daemon->accepted;
+        daemon->pending = batch;
+        daemon->pending_cap = batch_cap;
+        daemon->pending_cnt = 0;
+        batch = changes;
+        batch_cap = change_cap;
+        pthread_mutex_unlock(&daemon->lock);
+
+        if (daemon->log_cnt + change_cnt > daemon->log_cap) {
+            while (daemon->log_cnt + change_cnt > daemon->log_cap) {
+                daemon->log_cap = daemon->log_cap ? daemon->log_cap * 2 : 64;
+            }
+            daemon->log = (Link*)realloc(daemon->log, sizeof(Link) * daemon->log_cap);
+        }
+        memcpy(daemon->log + daemon->log_cnt, batch, sizeof(Link) * change_cnt);
+        daemon->log_cnt += change_cnt;
+        for (int k = 0; k < change_cnt; k++) {
+            if (batch[k].cost >= 0 && batch[k].cost < LINK_NONE) {
+                route_table_reserve(&daemon->work, batch[k].cost);
+            }
+            daemon->engine->apply(daemon->engine->ctx, batch[k].src, batch[k].dst, batch[k].cost);
+        }
+        daemon->engine->compute(daemon->engine->ctx, (int)version, &daemon->work);
+        daemon_publish(daemon, version);
+
+        pthread_mutex_lock(&daemon->lock);
+        daemon->applied = version;
+        pthread_cond_broadcast(&daemon->published);
+    }
+    pthread_mutex_unlock(&daemon->lock);
+    free(batch);
+    return NULL;
+}
+
+// 경로를 따라가며 hop 목록을 씀 (게시된 스냅샷에는 루프가 없지만 노드 수만큼만 따라감)
+static inline void daemon_path(DaemonBuf* out, const RouteTable* table, int from, int to) {
+    uint32_t distance = route_get_dist(table, from, to);
+    if (distance == ROUTE_NONE) {
+        daemon_buf_text(out, "unreachable\n");
+        return;
+    }
+    daemon_buf_text(out, "cost ");
+    daemon_buf_number(out, distance, ' ');
+    daemon_buf_text(out, "hops ");
+    int hop = from;
+    for (int k = 0; k < table->node_cnt; k++) {
+        daemon_buf_number(out, hop, ' ');
+        uint32_t next = route_get_next(table, hop, to);
+        if (next == (uint32_t)to || next == ROUTE_NONE) {
+            break;
+        }
+        hop = (int)next;
+    }
+    daemon_buf_text(out, "\n");
+}
+
+// 명령 한 줄 처리, 연결을 닫아야 하면 0
+static inline int daemon_command(Daemon* daemon, DaemonClient* client, char* line, size_t len, DaemonBuf* out) {
+    Scanner scanner;
+    scanner.pos = line;
+    scanner.end = line + len;
+    scanner.line = 1;
+    scan_space(&scanner);
+    const char* word = scanner.pos;
+    while (scanner.pos < scanner.end && *scanner.pos != ' ' && *scanner.pos != '\t' && *scanner.pos != '\r') {
+        scanner.pos++;
+    }
+    size_t word_len = (size_t)(scanner.pos - word);
+    int from, to, cost;
+
+    if (word_len == 0) {
+        return 1; // 빈 줄
+    }
+    if ((word_len == 5 && memcmp(word, "route", 5) == 0) || (word_len == 4 && memcmp(word, "path", 4) == 0)) {
+        if (!scan_int(&scanner, &from) || !scan_int(&scanner, &to) ||
+            from < 0 || from >= daemon->node_cnt || to < 0 || to >= daemon->node_cnt) {
+            daemon_buf_text(out, "error invalid nodes\n");
+            return 1;
+        }
+        const DaemonSnapshot* snapshot = daemon_read_begin(daemon, client);
+        if (word_len == 4) {
+            daemon_path(out, &snapshot->table, from, to);
+        } else {
+            uint32_t distance = route_get_dist(&snapshot->table, from, to);
+            uint32_t next = route_get_next(&snapshot->table, from, to);
+            daemon_read_end(client);
+            if (distance == ROUTE_NONE) {
+                daemon_buf_text(out, "unreachable\n");
+            } else {
+                daemon_buf_number(out, next, ' ');
+                daemon_buf_number(out, distance, '\n');
+            }
+            return 1;
+        }
+        daemon_read_end(client);
+    } else if (word_len == 6 && memcmp(word, "change", 6) == 0) {
+        if (!scan_int(&scanner, &from) || !scan_int(&scanner, &to) || !scan_int(&scanner, &cost) ||
+            from < 0 || from >= daemon->node_cnt || to < 0 || to >= daemon->node_cnt) {
+            daemon_buf_text(out, "error invalid change\n");
+            return 1;
+        }
+        pthread_mutex_lock(&daemon->lock);
+        if (daemon->pending_cnt == daemon->pending_cap) {
+            daemon->pending_cap = daemon->pending_cap ? daemon->pending_cap * 2 : 64;
+            daemon->pending = (Link*)realloc(daemon->pending, sizeof(Link) * daemon->pending_cap);
+        }
+        Link* change = &daemon->pending[daemon->pending_cnt++];
+        change->src = from;
+        change->dst = to;
+        change->cost = cost;
+        change->line = 0;
+        long long accepted = ++daemon->accepted;
+        pthread_cond_signal(&daemon->changed);
+        pthread_mutex_unlock(&daemon->lock);
+        daemon_buf_text(out, "ok ");
+        daemon_buf_number(out, accepted, '\n');
+    } else if (word_len == 4 && memcmp(word, "sync", 4) == 0) {
+        pthread_mutex_lock(&daemon->lock);
+        long long target = daemon->accepted;
+        while (daemon->applied < target && !daemon->stop) {
+            pthread_cond_wait(&daemon->published, &daemon->lock);
+        }
+        long long applied = daemon->applied;
+        pthread_mutex_unlock(&daemon->lock);
+        daemon_buf_text(out, "version ");
+        daemon_buf_number(out, applied, '\n');
+    } else if (word_len == 7 && memcmp(word, "version", 7) == 0) {
+        const DaemonSnapshot* snapshot = daemon_read_begin(daemon, client);
+        long long version = snapshot->version;
+        daemon_read_end(client);
+        daemon_buf_text(out, "version ");
+        daemon_buf_number(out, version, '\n');
+    } else if (word_len == 8 && memcmp(word, "shutdown", 8) == 0) {
+        daemon_buf_text(out, "bye\n");
+        daemon_buf_send(out, client->fd); // 남은 연결을 끊기 전에 응답을 보냄
+        pthread_mutex_lock(&daemon->lock);
+        daemon->stop = 1;
+        pthread_cond_broadcast(&daemon->changed);
+        pthread_cond_broadcast(&daemon->published);
+        pthread_mutex_unlock(&daemon->lock);
+        shutdown(daemon->listen_fd, SHUT_RDWR); // accept를 깨움
+        return 0;
+    } else {
+        daemon_buf_text(out, "error unknown command\n");
+    }
+    return 1;
+}
+
+// 연결 하나를 맡는 스레드 - 읽은 만큼의 줄을 처리하고 응답을 한 번에 보냄
+static void* daemon_client_thread(void* arg) {
+    DaemonClient* client = (DaemonClient*)arg;
+    Daemon* daemon = client->daemon;
+    char* in = (char*)malloc(DAEMON_READ_BUF);
+    size_t in_len = 0;
+    DaemonBuf out = {NULL, 0, 0};
+    int open = 1;
+    int skip = 0;       // 너무 긴 줄의 나머지를 버리는 중
+
+    while (open) {
+        ssize_t n = read(client->fd, in + in_len, DAEMON_READ_BUF - in_len);
+        if (n <= 0) {
+            break;
+        }
+        in_len += (size_t)n;
+        char* line = in;
+        char* end = in + in_len;
+        char* newline;
+        while (open && (newline = (char*)memchr(line, '\n', (size_t)(end - line))) != NULL) {
+            if (skip) {
+                skip = 0;
+            } else {
+                open = daemon_command(daemon, client, line, (size_t)(newline - line), &out);
+            }
+            line = newline + 1;
+        }
+        in_len = (size_t)(end - line);
+        if (in_len == DAEMON_READ_BUF || (skip && in_len > 0)) {
+            if (!skip) {
+                daemon_buf_text(&out, "error line too long\n");
+            }
+            skip = 1;
+            in_len = 0;
+        } else {
+            memmove(in, line, in_len);
+        }
+        if (!daemon_buf_send(&out, client->fd)) {
+            break;
+        }
+    }
+
+    free(in);
+    free(out.data);
+    pthread_mutex_lock(&daemon->lock);
+    close(client->fd);
+    client->used = 0;
+    daemon->active--;
+    pthread_cond_broadcast(&daemon->published);
+    pthread_mutex_unlock(&daemon->lock);
+    return NULL;
+}
+
+// 데몬 실행 - 처음 상태를 계산해 게시하고 shutdown 명령이 올 때까지 연결을 받음. 소켓 오류면 -1
+static inline int daemon_run(const char* path, int node_cnt, int max_weight, const DaemonEngine* engine) {
+    struct sockaddr_un address;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        printf("Error: socket path too long %s\n", path);
+        return -1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path); // 지난 실행이 남긴 소켓 파일
+    if (listen_fd < 0 || bind(listen_fd, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(listen_fd, DAEMON_MAX_CLIENTS) != 0) {
+        printf("Error: cannot listen on %s\n", path);
+        if (listen_fd >= 0) {
+            close(listen_fd);
+        }
+        return -1;
+    }
+
+    Daemon* daemon = (Daemon*)calloc(1, sizeof(Daemon));
+    daemon->engine = engine;
+    daemon->node_cnt = node_cnt;
+    daemon->listen_fd = listen_fd;
+    daemon->epoch = 1;
+    pthread_mutex_init(&daemon->lock, NULL);
+    pthread_cond_init(&daemon->changed, NULL);
+    pthread_cond_init(&daemon->published, NULL);
+
+    // 처음 상태 계산 (스냅샷에서 시작하면 그 테이블을 그대로 씀)
+    route_table_init(&daemon->work, node_cnt, max_weight);
+    if (engine->initial) {
+        route_table_copy(&daemon->work, engine->initial);
+    } else {
+        engine->compute(engine->ctx, 0, &daemon->work);
+    }
+    daemon->accepted = daemon->applied = engine->history_cnt;
+    daemon->log_cnt = daemon->log_cap = engine->history_cnt;
+    daemon->log = (Link*)malloc(sizeof(Link) * (engine->history_cnt > 0 ? engine->history_cnt : 1));
+    if (engine->history_cnt > 0) {
+        memcpy(daemon->log, engine->history, sizeof(Link) * engine->history_cnt);
+    }
+    for (int s = 0; s < 2; s++) {
+        route_table_init(&daemon->snapshots[s].table, node_cnt, max_weight);
+        daemon->snapshots[s].version = engine->history_cnt;
+    }
+    route_table_copy(&daemon->snapshots[0].table, &daemon->work);
+    daemon->current = &daemon->snapshots[0];
+    daemon->spare = &daemon->snapshots[1];
+    pthread_create(&daemon->writer, NULL, daemon_writer, daemon);
+    printf("Listening on %s (%d nodes)\n", path, node_cnt);
+    fflush(stdout);
+
+    for (;;) {
+        int fd = accept(listen_fd, NULL, NULL);
+        pthread_mutex_lock(&daemon->lock);
+        int stop = daemon->stop;
+        pthread_mutex_unlock(&daemon->lock);
+        if (stop) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            break;
+        }
+        if (fd < 0) {
+            continue;
+        }
+
+        pthread_mutex_lock(&daemon->lock);
+        DaemonClient* client = NULL;
+        for (int c = 0; c < DAEMON_MAX_CLIENTS && !client; c++) {
+            if (!daemon->clients[c].used) {
+                client = &daemon->clients[c];
+            }
+        }
+        if (client) {
+            client->used = 1;
+            client->fd = fd;
+            client->daemon = daemon;
+            daemon->active++;
+        }
+        pthread_mutex_unlock(&daemon->lock);
+        if (!client) {
+            const char* busy = "error too many clients\n";
+            send(fd, busy, strlen(busy), MSG_NOSIGNAL);
+            close(fd);
+            continue;
+        }
+        pthread_t thread;
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        pthread_create(&thread, &attr, daemon_client_thread, client);
+        pthread_attr_destroy(&attr);
+    }
+
+    // 남은 연결을 끊고 모든 연결 스레드와 재계산 스레드가 끝나기를 기다림
+    pthread_join(daemon->writer, NULL);
+    pthread_mutex_lock(&daemon->lock);
+    for (int c = 0; c < DAEMON_MAX_CLIENTS; c++) {
+        if (daemon->clients[c].used) {
+            shutdown(daemon->clients[c].fd, SHUT_RDWR);
+        }
+    }
+    while (daemon->active > 0) {
+        pthread_cond_wait(&daemon->published, &daemon->lock);
+    }
+    pthread_mutex_unlock(&daemon->lock);
+    close(listen_fd);
+    unlink(path);
+    printf("Daemon stopped after %lld changes\n", daemon->applied);
+    if (engine->save) {
+        engine->save(engine->ctx, daemon->log, daemon->log_cnt, &daemon->work);
+    }
+
+    route_table_free(&daemon->work);
+    for (int s = 0; s < 2; s++) {
+        route_table_free(&daemon->snapshots[s].table);
+    }
+    free(daemon->pending);
+    free(daemon->log);
+    pthread_cond_destroy(&daemon->changed);
+    pthread_cond_destroy(&daemon->published);
+    pthread_mutex_destroy(&daemon->lock);
+    free(daemon);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef ROUTING_FW_H
+#define ROUTING_FW_H
+
+#include "routing_table.h"
+#include "routing_simd.h"
+#include "routing_pool.h"
+
+#define FW_TILE 64      // 타일 한 변의 노드 수 (uint32_t 기준 타일 하나가 16KB)
+
+// 타일 단위(cache-blocked) Floyd-Warshall
+// 라우팅 테이블의 거리/다음 홉 배열을 그대로 행렬로 사용하며, 링크 정보로 채운 테이블에서 시작
+// 중간 노드 블록 kb마다 1) 대각 타일 (kb, kb) 2) 같은 행/열의 타일 3) 나머지 타일 순서로 갱신
+// 2단계와 3단계의 타일들은 서로 겹치지 않는 칸에만 쓰고 이미 끝난 타일만 읽으므로 스레드 풀에서 나눠 처리
+// 더 짧아질 때만 바꾸고 타일 크기가 고정이므로 결과는 스레드 수와 상관없이 같음
+
+typedef struct FwJob_ {
+    RouteTable* table;
+    int tile_cnt;       // 한 변의 타일 수
+    int kb;             // 현재 중간 노드 블록
+    int phase;          // 2: 행/열 타일, 3: 나머지 타일
+} FwJob;
+
+// 타일 (ib, jb)를 블록 kb의 중간 노드들로 갱신 - i 행의 j 구간을 k 행의 같은 구간으로 min-plus
+template <typename T>
+static inline void fw_tile(RouteTable* table, int kb, int ib, int jb) {
+    int node_cnt = table->node_cnt;
+    T* dist = route_dist<T>(table);
+    T* next = route_next<T>(table);
+    int k_end = (kb + 1) * FW_TILE < node_cnt ? (kb + 1) * FW_TILE : node_cnt;
+    int i_end = (ib + 1) * FW_TILE < node_cnt ? (ib + 1) * FW_TILE : node_cnt;
+    int j_begin = jb * FW_TILE;
+    int width = ((jb + 1) * FW_TILE < node_cnt ? (jb + 1) * FW_TILE : node_cnt) - j_begin;
+
+    for (int k = kb * FW_TILE; k < k_end; k++) {
+        const T* k_dist = dist + (size_t)k * node_cnt + j_begin;
+        for (int i = ib * FW_TILE; i < i_end; i++) {
+            size_t row = (size_t)i * node_cnt;
+            T link = dist[row + k];
+            if (i == k || link == route_infinity<T>()) {
+                continue;
+            }
+            relax_row(dist + row + j_begin, next + row + j_begin, k_dist, link, next[row + k], width);
+        }
+    }
+}
+
+template <typename T>
+static void fw_task(void* ctx, int worker, int index) {
+    (void)worker;
+    FwJob* job = (FwJob*)ctx;
+    int others = job->tile_cnt - 1;     // kb를 제외한 블록 수
+    int kb = job->kb;
+    if (job->phase == 2) {
+        int other = index % others;
+        other += other >= kb;
+        if (index < others) {
+            fw_tile<T>(job->table, kb, kb, other);
+        } else {
+            fw_tile<T>(job->table, kb, other, kb);
+        }
+    } else {
+        int ib = index / others;
+        int jb = index % others;
+        ib += ib >= kb;
+        jb += jb >= kb;
+        fw_tile<T>(job->table, kb, ib, jb);
+    }
+}
+
+template <typename T>
+static void fw_run(RouteTable* table, WorkerPool* pool) {
+    FwJob job;
+    job.table = table;
+    job.tile_cnt = (table->node_cnt + FW_TILE - 1) / FW_TILE;
+    int others = job.tile_cnt - 1;
+
+    for (job.kb = 0; job.kb < job.tile_cnt; job.kb++) {
+        fw_tile<T>(table, job.kb, job.kb, job.kb);
+        if (others == 0) {
+            continue;
+        }
+        job.phase = 2;
+        pool_run(pool, 2 * others, fw_task<T>, &job);
+        job.phase = 3;
+        pool_run(pool, others * others, fw_task<T>, &job);
+    }
+}
+
+// 테이블 자료형에 맞는 버전 실행
+static inline void floyd_warshall(RouteTable* table, WorkerPool* pool) {
+    if (table->compact) {
+        fw_run<uint16_t>(table, pool);
+    } else {
+        fw_run<uint32_t>(table, pool);
+    }
+}
+
+#endif
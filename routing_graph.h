@@ -0,0 +1,246 @@
+#ifndef ROUTING_GRAPH_H
+#define ROUTING_GRAPH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <limits>
+#include "routing_input.h"
+
+#define ROUTE_INFINITY INT_MAX  // 도달 불가 거리
+#define LINK_NONE 999           // 파일 형식에서 링크 없음을 의미하는 비용 (이 값 이상이면 링크가 아님)
+#define LINK_DOWN -999          // 변경 파일에서 링크 끊김을 의미하는 값
+
+// 자료형의 최댓값을 무한대(도달 불가, 다음 홉 없음)로 사용
+template <typename T>
+static inline T route_infinity() {
+    return std::numeric_limits<T>::max();
+}
+
+// 넘치지 않는 거리 덧셈 - 어느 한쪽이 무한대이거나 합이 최댓값에 닿으면 무한대
+template <typename T>
+static inline T route_add(T a, T b) {
+    const T inf = route_infinity<T>();
+    if (a == inf || b == inf || (b > 0 && a >= inf - b)) {
+        return inf;
+    }
+    return (T)(a + b);
+}
+
+// 희소 인접 구조 (CSR) - 노드 i의 이웃은 adj[offset[i]] ~ adj[offset[i] + degree[i] - 1]
+// 각 노드 구간에는 여유 칸(offset[i + 1] - offset[i] - degree[i])이 있어 링크 추가 시 사용
+typedef struct Graph_ {
+    int node_cnt;
+    int* offset;        // 노드별 시작 위치 (node_cnt + 1개)
+    int* degree;        // 노드별 실제 이웃 수
+    int* adj;           // 이웃 노드
+    int* weight;        // 링크 비용
+    int zero_cnt;       // 비용 0인 방향 링크 수 (부분 재계산이 가능한지 판단할 때 사용)
+} Graph;
+
+static inline void graph_free(Graph* graph) {
+    free(graph->offset);
+    free(graph->degree);
+    free(graph->adj);
+    free(graph->weight);
+    graph->offset = graph->degree = graph->adj = graph->weight = NULL;
+    graph->node_cnt = 0;
+    graph->zero_cnt = 0;
+}
+
+// 링크 (u, v)가 저장된 위치 반환, 없으면 -1
+static inline int graph_find(const Graph* graph, int u, int v) {
+    int begin = graph->offset[u];
+    int end = begin + graph->degree[u];
+    for (int i = begin; i < end; i++) {
+        if (graph->adj[i] == v) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// 링크 비용 반환 (자기 자신은 0, 링크가 없으면 LINK_NONE) - 인접 행렬의 값과 같음
+static inline int graph_link_cost(const Graph* graph, int u, int v) {
+    if (u == v) {
+        return 0;
+    }
+    int slot = graph_find(graph, u, v);
+    return slot < 0 ? LINK_NONE : graph->weight[slot];
+}
+
+// 가장 큰 링크 비용 (라우팅 테이블의 자료형을 정할 때 사용)
+static inline int graph_max_weight(const Graph* graph) {
+    int max_weight = 0;
+    for (int u = 0; u < graph->node_cnt; u++) {
+        for (int k = graph->offset[u]; k < graph->offset[u] + graph->degree[u]; k++) {
+            if (graph->weight[k] > max_weight) {
+                max_weight = graph->weight[k];
+            }
+        }
+    }
+    return max_weight;
+}
+
+// 노드 u의 구간이 가득 찬 경우 전체 배열을 다시 만들어 u의 여유 칸을 늘림
+static inline void graph_grow(Graph* graph, int u) {
+    int node_cnt = graph->node_cnt;
+    int* offset = (int*)malloc(sizeof(int) * (node_cnt + 1));
+    int total = 0;
+    for (int i = 0; i < node_cnt; i++) {
+        int capacity = graph->offset[i + 1] - graph->offset[i];
+        if (i == u) {
+            capacity = capacity < 2 ? 4 : capacity * 2;
+        }
+        offset[i] = total;
+        total += capacity;
+    }
+    offset[node_cnt] = total;
+
+    int* adj = (int*)malloc(sizeof(int) * (total > 0 ? total : 1));
+    int* weight = (int*)malloc(sizeof(int) * (total > 0 ? total : 1));
+    for (int i = 0; i < node_cnt; i++) {
+        for (int k = 0; k < graph->degree[i]; k++) {
+            adj[offset[i] + k] = graph->adj[graph->offset[i] + k];
+            weight[offset[i] + k] = graph->weight[graph->offset[i] + k];
+        }
+    }
+    free(graph->offset);
+    free(graph->adj);
+    free(graph->weight);
+    graph->offset = offset;
+    graph->adj = adj;
+    graph->weight = weight;
+}
+
+// 한 방향 링크 저장 (있으면 비용만 갱신)
+static inline void graph_set_arc(Graph* graph, int u, int v, int cost) {
+    int slot = graph_find(graph, u, v);
+    if (slot < 0) {
+        if (graph->offset[u] + graph->degree[u] == graph->offset[u + 1]) {
+            graph_grow(graph, u);
+        }
+        slot = graph->offset[u] + graph->degree[u]++;
+        graph->adj[slot] = v;
+    } else {
+        graph->zero_cnt -= graph->weight[slot] == 0;
+    }
+    graph->weight[slot] = cost;
+    graph->zero_cnt += cost == 0;
+}
+
+// 한 방향 링크 제거 (구간의 마지막 이웃을 빈 자리로 옮김)
+static inline void graph_remove_arc(Graph* graph, int u, int v) {
+    int slot = graph_find(graph, u, v);
+    if (slot < 0) {
+        return;
+    }
+    graph->zero_cnt -= graph->weight[slot] == 0;
+    int last = graph->offset[u] + --graph->degree[u];
+    graph->adj[slot] = graph->adj[last];
+    graph->weight[slot] = graph->weight[last];
+}
+
+// 양방향 링크 설정 / 제거
+static inline void graph_set_link(Graph* graph, int u, int v, int cost) {
+    graph_set_arc(graph, u, v, cost);
+    graph_set_arc(graph, v, u, cost);
+}
+
+static inline void graph_remove_link(Graph* graph, int u, int v) {
+    graph_remove_arc(graph, u, v);
+    graph_remove_arc(graph, v, u);
+}
+
+// 토폴로지의 링크 배열로 그래프 생성 (자기 자신 링크는 무시, 같은 링크가 여러 번 나오면 마지막 값 사용)
+// 마지막 비용이 음수이거나 LINK_NONE 이상인 링크는 없는 링크로 취급
+static inline void graph_load(const Topology* topology, Graph* graph) {
+    int node_cnt = topology->node_cnt;
+    const Link* links = topology->links;
+    int link_cnt = topology->link_cnt;
+
+    // 노드별 이웃 수를 세어 구간 배치
+    graph->node_cnt = node_cnt;
+    graph->zero_cnt = 0;
+    graph->offset = (int*)calloc(node_cnt + 1, sizeof(int));
+    graph->degree = (int*)calloc(node_cnt > 0 ? node_cnt : 1, sizeof(int));
+    for (int i = 0; i < link_cnt; i++) {
+        if (links[i].src != links[i].dst) {
+            graph->offset[links[i].src + 1]++;
+            graph->offset[links[i].dst + 1]++;
+        }
+    }
+    for (int i = 0; i < node_cnt; i++) {
+        graph->offset[i + 1] += graph->offset[i];
+    }
+    int total = graph->offset[node_cnt];
+    graph->adj = (int*)malloc(sizeof(int) * (total > 0 ? total : 1));
+    graph->weight = (int*)malloc(sizeof(int) * (total > 0 ? total : 1));
+
+    // 중복 링크는 마지막 값으로 덮어씀 (last_slot으로 노드별 위치 기억)
+    int* last_slot = (int*)malloc(sizeof(int) * (node_cnt > 0 ? node_cnt : 1));
+    for (int i = 0; i < node_cnt; i++) {
+        last_slot[i] = -1;
+    }
+    int* arc_order = (int*)malloc(sizeof(int) * (total + 1));
+    int* fill = (int*)calloc(node_cnt > 0 ? node_cnt : 1, sizeof(int));
+    for (int i = 0; i < link_cnt; i++) {
+        if (links[i].src == links[i].dst) {
+            continue;
+        }
+        // 파일 순서를 유지하면서 출발 노드별로 정렬
+        for (int dir = 0; dir < 2; dir++) {
+            int u = dir == 0 ? links[i].src : links[i].dst;
+            int k = graph->offset[u] + fill[u]++;
+            arc_order[k] = 2 * i + dir;
+        }
+    }
+    for (int u = 0; u < node_cnt; u++) {
+        int begin = graph->offset[u];
+        int end = begin + fill[u];
+        for (int k = begin; k < end; k++) {
+            int i = arc_order[k] / 2;
+            int v = arc_order[k] % 2 == 0 ? links[i].dst : links[i].src;
+            if (last_slot[v] < 0) {
+                last_slot[v] = begin + graph->degree[u]++;
+                graph->adj[last_slot[v]] = v;
+            }
+            graph->weight[last_slot[v]] = links[i].cost;
+        }
+        for (int k = begin; k < begin + graph->degree[u]; k++) {
+            last_slot[graph->adj[k]] = -1;
+            graph->zero_cnt += graph->weight[k] == 0;
+        }
+        for (int k = begin + graph->degree[u] - 1; k >= begin; k--) {
+            if (graph->weight[k] < 0 || graph->weight[k] >= LINK_NONE) {
+                graph_remove_arc(graph, u, graph->adj[k]);
+            }
+        }
+    }
+
+    free(fill);
+    free(arc_order);
+    free(last_slot);
+}
+
+// 변경 사항 하나를 그래프에 적용 (change_network와 같은 규칙)
+// -999는 링크 제거, 그 외에는 기존 비용보다 작을 때만 반영 (음수 비용은 무시). 그래프가 바뀌면 1 반환
+static inline int graph_apply_change(Graph* graph, int source, int destination, int distance) {
+    if (source == destination || (distance < 0 && distance != LINK_DOWN)) {
+        return 0;
+    }
+    if (distance == LINK_DOWN) {
+        if (graph_find(graph, source, destination) < 0) {
+            return 0;
+        }
+        graph_remove_link(graph, source, destination);
+        return 1;
+    }
+    if (graph_link_cost(graph, source, destination) > distance) {
+        graph_set_link(graph, source, destination, distance);
+        return 1;
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef ROUTING_HEAP_H
+#define ROUTING_HEAP_H
+
+#include <stdlib.h>
+
+// 인덱스 이진 힙 - (거리, 노드 번호) 순으로 가장 작은 노드를 꺼냄
+// 거리 배열은 외부(key)에 두고, pos 배열로 decrease-key를 지원
+typedef struct Heap_ {
+    int size;
+    int* nodes;         // 힙 배열 (노드 번호)
+    int* pos;           // 노드 -> 힙 위치, 힙에 없으면 -1
+    const int* key;     // 비교에 사용하는 거리 배열
+} Heap;
+
+static inline void heap_init(Heap* heap, int node_cnt) {
+    heap->size = 0;
+    heap->nodes = (int*)malloc(sizeof(int) * (node_cnt > 0 ? node_cnt : 1));
+    heap->pos = (int*)malloc(sizeof(int) * (node_cnt > 0 ? node_cnt : 1));
+    for (int i = 0; i < node_cnt; i++) {
+        heap->pos[i] = -1;
+    }
+    heap->key = NULL;
+}
+
+static inline void heap_free(Heap* heap) {
+    free(heap->nodes);
+    free(heap->pos);
+    heap->nodes = NULL;
+    heap->pos = NULL;
+    heap->size = 0;
+}
+
+// 거리가 같으면 번호가 작은 노드가 먼저 (smallest_index와 같은 순서)
+static inline int heap_less(const Heap* heap, int a, int b) {
+    return heap->key[a] < heap->key[b] || (heap->key[a] == heap->key[b] && a < b);
+}
+
+static inline void heap_place(Heap* heap, int index, int node) {
+    heap->nodes[index] = node;
+    heap->pos[node] = index;
+}
+
+static inline void heap_sift_up(Heap* heap, int index) {
+    int node = heap->nodes[index];
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!heap_less(heap, node, heap->nodes[parent])) {
+            break;
+        }
+        heap_place(heap, index, heap->nodes[parent]);
+        index = parent;
+    }
+    heap_place(heap, index, node);
+}
+
+static inline void heap_sift_down(Heap* heap, int index) {
+    int node = heap->nodes[index];
+    for (;;) {
+        int child = 2 * index + 1;
+        if (child >= heap->size) {
+            break;
+        }
+        if (child + 1 < heap->size && heap_less(heap, heap->nodes[child + 1], heap->nodes[child])) {
+            child++;
+        }
+        if (!heap_less(heap, heap->nodes[child], node)) {
+            break;
+        }
+        heap_place(heap, index, heap->nodes[child]);
+        index = child;
+    }
+    heap_place(heap, index, node);
+}
+
+// 노드를 넣거나, 이미 있으면 줄어든 거리에 맞춰 위치를 올림
+static inline void heap_push(Heap* heap, int node) {
+    if (heap->pos[node] < 0) {
+        heap_place(heap, heap->size, node);
+        heap->size++;
+    }
+    heap_sift_up(heap, heap->pos[node]);
+}
+
+// 키가 늘었거나 줄어든 노드의 위치를 고침 (힙에 없으면 넣음)
+static inline void heap_update(Heap* heap, int node) {
+    heap_push(heap, node);
+    heap_sift_down(heap, heap->pos[node]);
+}
+
+// 가장 작은 노드를 꺼냄 (꺼낸 노드의 pos는 -1로 되돌림)
+static inline int heap_pop(Heap* heap) {
+    int top = heap->nodes[0];
+    heap->pos[top] = -1;
+    heap->size--;
+    if (heap->size > 0) {
+        heap_place(heap, 0, heap->nodes[heap->size]);
+        heap_sift_down(heap, 0);
+    }
+    return top;
+}
+
+#endif
@@ -0,0 +1,260 @@
+#ifndef ROUTING_INPUT_H
+#define ROUTING_INPUT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// 입력 로더 - 입력 파일을 한 번만 메모리에 매핑(mmap)하고 직접 만든 스캐너로 정수를 읽음
+// 토폴로지는 링크 배열, 변경 파일은 변경 사항 배열로 만들어 두 프로그램의 모든 엔진이 같이 사용
+// 노드 번호는 토폴로지 첫 줄의 노드 수 안에 있는지 확인하고, 벗어나면 줄 번호와 함께 오류를 알림
+
+// 매핑한 입력 (일반 파일이 아니면 - stdin, 파이프 - 전체를 읽어 둠)
+typedef struct InputText_ {
+    const char* data;
+    size_t len;
+    void* map;          // mmap한 경우 매핑 주소
+    char* copy;         // 읽어 둔 경우 버퍼
+} InputText;
+
+// 스캐너 - fscanf("%d")처럼 공백(개행 포함)을 건너뛰고 정수를 읽으며, 지나간 개행 수로 줄 번호를 셈
+typedef struct Scanner_ {
+    const char* pos;
+    const char* end;
+    int line;           // 마지막으로 읽은 정수의 줄 번호 (1부터)
+} Scanner;
+
+// 링크 하나 또는 변경 사항 하나 "노드 노드 비용"
+typedef struct Link_ {
+    int src;
+    int dst;
+    int cost;
+    int line;           // 입력 파일의 줄 번호
+    long long time;     // 변경 사항의 시각 (변경 파일의 네 번째 열, ms - 없으면 앞 변경 사항의 시각)
+} Link;
+
+typedef struct Topology_ {
+    int node_cnt;
+    Link* links;        // 파일 순서 그대로 (자기 자신 링크, 없는 링크 비용도 포함)
+    int link_cnt;
+} Topology;
+
+typedef struct ChangeList_ {
+    Link* changes;
+    int change_cnt;
+} ChangeList;
+
+static inline void input_open(InputText* input, FILE* file) {
+    struct stat st;
+    input->map = NULL;
+    input->copy = NULL;
+    int fd = fileno(file);
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+            input->map = map;
+            input->data = (const char*)map;
+            input->len = (size_t)st.st_size;
+            return;
+        }
+    }
+
+    size_t cap = 4096, len = 0;
+    char* copy = (char*)malloc(cap);
+    for (;;) {
+        if (len == cap) {
+            cap *= 2;
+            copy = (char*)realloc(copy, cap);
+        }
+        size_t got = fread(copy + len, 1, cap - len, file);
+        if (got == 0) {
+            break;
+        }
+        len += got;
+    }
+    input->copy = copy;
+    input->data = copy;
+    input->len = len;
+}
+
+static inline void input_close(InputText* input) {
+    if (input->map) {
+        munmap(input->map, input->len);
+    }
+    free(input->copy);
+    input->map = NULL;
+    input->copy = NULL;
+    input->data = NULL;
+    input->len = 0;
+}
+
+static inline void scanner_init(Scanner* scanner, const InputText* input) {
+    scanner->pos = input->data;
+    scanner->end = input->data + input->len;
+    scanner->line = 1;
+}
+
+// 공백과 개행을 건너뜀
+static inline void scan_space(Scanner* scanner) {
+    const char* p = scanner->pos;
+    while (p < scanner->end && (*p == ' ' || *p == '\n' || *p == '\t' || *p == '\r' || *p == '\v' || *p == '\f')) {
+        scanner->line += *p == '\n';
+        p++;
+    }
+    scanner->pos = p;
+}
+
+// 정수 하나를 읽음, 정수가 아니면 0 (범위를 넘는 값은 int 범위로 자름)
+static inline int scan_int(Scanner* scanner, int* value) {
+    scan_space(scanner);
+    const char* p = scanner->pos;
+    int negative = 0;
+    if (p < scanner->end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+    if (p >= scanner->end || (unsigned)(*p - '0') > 9) {
+        return 0;
+    }
+    long long number = 0;
+    while (p < scanner->end && (unsigned)(*p - '0') <= 9) {
+        if (number <= INT_MAX) {
+            number = number * 10 + (*p - '0');
+        }
+        p++;
+    }
+    if (negative) {
+        number = -number < INT_MIN ? INT_MIN : -number;
+    } else if (number > INT_MAX) {
+        number = INT_MAX;
+    }
+    *value = (int)number;
+    scanner->pos = p;
+    return 1;
+}
+
+// "노드 노드 비용" 세 정수를 읽음 (셋 다 읽혀야 1)
+static inline int scan_link(Scanner* scanner, Link* link) {
+    const char* start = scanner->pos;
+    int line = scanner->line;
+    if (scan_int(scanner, &link->src)) {
+        link->line = scanner->line;
+        link->time = 0;
+        if (scan_int(scanner, &link->dst) && scan_int(scanner, &link->cost)) {
+            return 1;
+        }
+    }
+    scanner->pos = start;
+    scanner->line = line;
+    return 0;
+}
+
+// 같은 줄에 0 이상의 정수가 더 있으면 읽음 (변경 파일의 네 번째 열 - 시각). 없으면 0
+static inline int scan_time(Scanner* scanner, long long* value) {
+    const char* p = scanner->pos;
+    while (p < scanner->end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        p++;
+    }
+    if (p >= scanner->end || (unsigned)(*p - '0') > 9) {
+        return 0;
+    }
+    long long number = 0;
+    while (p < scanner->end && (unsigned)(*p - '0') <= 9) {
+        if (number <= LLONG_MAX / 10 - 9) {
+            number = number * 10 + (*p - '0');
+        }
+        p++;
+    }
+    *value = number;
+    scanner->pos = p;
+    return 1;
+}
+
+// 노드 번호 확인 - 벗어나면 오류를 알리고 0
+static inline int input_check_node(const char* what, int line, int node, int node_cnt) {
+    if (node < 0 || node >= node_cnt) {
+        printf("Error: %s line %d: node %d out of range (0-%d)\n", what, line, node, node_cnt - 1);
+        return 0;
+    }
+    return 1;
+}
+
+// 세 정수로 읽히는 줄들을 배열로 (읽히지 않는 곳에서 멈춤 - fscanf("%d %d %d\n") 반복과 같음)
+// timed면 같은 줄의 네 번째 정수를 시각으로 읽음
+static inline int scan_links(Scanner* scanner, const char* what, int node_cnt, int timed, Link** links, int* link_cnt) {
+    int cap = 64, cnt = 0;
+    Link* array = (Link*)malloc(sizeof(Link) * cap);
+    Link link;
+    long long time = 0;
+    while (scan_link(scanner, &link)) {
+        if (timed) {
+            scan_time(scanner, &time);
+            link.time = time;
+        }
+        if (!input_check_node(what, link.line, link.src, node_cnt) || !input_check_node(what, link.line, link.dst, node_cnt)) {
+            free(array);
+            return -1;
+        }
+        if (cnt == cap) {
+            cap *= 2;
+            array = (Link*)realloc(array, sizeof(Link) * cap);
+        }
+        array[cnt++] = link;
+    }
+    *links = array;
+    *link_cnt = cnt;
+    return 0;
+}
+
+// 토폴로지 파일 읽기 - 첫 정수는 노드 수, 이후 "노드 노드 비용" 링크들. 오류면 -1
+static inline int topology_load(Topology* topology, FILE* file) {
+    InputText input;
+    Scanner scanner;
+    input_open(&input, file);
+    scanner_init(&scanner, &input);
+
+    topology->links = NULL;
+    topology->link_cnt = 0;
+    if (!scan_int(&scanner, &topology->node_cnt) || topology->node_cnt < 0) {
+        printf("Error: topology line %d: missing node count\n", scanner.line);
+        input_close(&input);
+        return -1;
+    }
+    int result = scan_links(&scanner, "topology", topology->node_cnt, 0, &topology->links, &topology->link_cnt);
+    input_close(&input);
+    return result;
+}
+
+static inline void topology_free(Topology* topology) {
+    free(topology->links);
+    topology->links = NULL;
+    topology->link_cnt = 0;
+}
+
+// 변경 파일 읽기 (일반 파일일 때만 - stdin과 follow 모드는 ChangeStream이 한 줄씩 읽음). 오류면 -1
+// timed면 줄마다 네 번째 열(시각)을 읽음 (변경 사항을 묶을 때만 - 그 외에는 fscanf처럼 줄 구분 없이 세 정수씩)
+static inline int changes_load(ChangeList* list, FILE* file, int node_cnt, int timed) {
+    InputText input;
+    Scanner scanner;
+    input_open(&input, file);
+    scanner_init(&scanner, &input);
+    int result = scan_links(&scanner, "changes", node_cnt, timed, &list->changes, &list->change_cnt);
+    if (result != 0) {
+        list->changes = NULL;
+        list->change_cnt = 0;
+    }
+    input_close(&input);
+    return result;
+}
+
+static inline void changes_free(ChangeList* list) {
+    free(list->changes);
+    list->changes = NULL;
+    list->change_cnt = 0;
+}
+
+#endif
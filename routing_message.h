@@ -0,0 +1,221 @@
+#ifndef ROUTING_MESSAGE_H
+#define ROUTING_MESSAGE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "routing_input.h"
+#include "routing_table.h"
+#include "routing_output.h"
+
+// 메시지 엔진 - 메시지 파일을 한 번만 매핑해 두고, (송신자, 수신자) 쌍별로 묶음
+// 쌍마다 "from s to r cost ... message " 부분을 만들어 두고, 변경 사항 이후에는
+// 그 경로가 의존하는 칸(송신자의 거리, 경로상 라우터들의 다음 홉)이 그대로인지만 확인해 다시 사용
+
+typedef struct Message_ {
+    int pair;           // 속한 (송신자, 수신자) 쌍
+    const char* body;   // 매핑한 파일 안의 본문 (줄바꿈 포함, 길이 제한 없음)
+    size_t body_len;
+} Message;
+
+typedef struct MessagePair_ {
+    int sender;
+    int receiver;
+    int valid;          // text가 만들어져 있는지
+    uint32_t distance;  // text를 만들 때의 거리
+    int* hops;          // text를 만들 때 지난 라우터 (송신자 포함, 수신자 제외)
+    int hop_cnt;
+    int hop_cap;
+    char* text;         // "from s to r cost ... message "
+    size_t text_len;
+    size_t text_cap;
+} MessagePair;
+
+typedef struct MessageBatch_ {
+    InputText input;    // 메시지 파일 전체 (본문은 여기를 가리킴)
+    Message* messages;
+    int message_cnt;
+    MessagePair* pairs;
+    int pair_cnt;
+} MessageBatch;
+
+// 메시지 파일을 읽어 배치 생성 - "송신자 수신자 본문" 줄을 sender_to_reciever와 같은 규칙으로 나눔
+// (수신자 뒤의 공백과 빈 줄은 건너뛰고, 본문은 줄 끝까지)
+// 노드 번호가 node_cnt를 벗어나면 -1 (message_batch_free로 정리)
+static inline int message_batch_load(MessageBatch* batch, FILE* messagesfile, int node_cnt) {
+    input_open(&batch->input, messagesfile);
+
+    int message_cap = 64, pair_cap = 64;
+    batch->messages = (Message*)malloc(sizeof(Message) * message_cap);
+    batch->pairs = (MessagePair*)malloc(sizeof(MessagePair) * pair_cap);
+    batch->message_cnt = 0;
+    batch->pair_cnt = 0;
+
+    // (송신자, 수신자) -> 쌍 번호 해시 (열린 주소법, 크기는 2의 거듭제곱)
+    int bucket_cnt = 256;
+    int* buckets = (int*)malloc(sizeof(int) * bucket_cnt);
+    for (int i = 0; i < bucket_cnt; i++) {
+        buckets[i] = -1;
+    }
+
+    Scanner scanner;
+    scanner_init(&scanner, &batch->input);
+    int sender, receiver;
+    while (scan_int(&scanner, &sender) && scan_int(&scanner, &receiver)) {
+        if (!input_check_node("messages", scanner.line, sender, node_cnt) || !input_check_node("messages", scanner.line, receiver, node_cnt)) {
+            free(buckets);
+            return -1;
+        }
+        scan_space(&scanner);
+        const char* body = scanner.pos;
+        const char* end = (const char*)memchr(body, '\n', (size_t)(scanner.end - body));
+        size_t body_len = end ? (size_t)(end - body) + 1 : (size_t)(scanner.end - body);
+
+        // 쌍 찾기 / 추가
+        unsigned long long key = ((unsigned long long)(unsigned)sender << 32) | (unsigned)receiver;
+        size_t bucket = (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 40) & (bucket_cnt - 1);
+        while (buckets[bucket] >= 0 && (batch->pairs[buckets[bucket]].sender != sender || batch->pairs[buckets[bucket]].receiver != receiver)) {
+            bucket = (bucket + 1) & (bucket_cnt - 1);
+        }
+        int pair_index = buckets[bucket];
+        if (pair_index < 0) {
+            if (batch->pair_cnt == pair_cap) {
+                pair_cap *= 2;
+                batch->pairs = (MessagePair*)realloc(batch->pairs, sizeof(MessagePair) * pair_cap);
+            }
+            MessagePair* pair = &batch->pairs[batch->pair_cnt];
+            memset(pair, 0, sizeof(MessagePair));
+            pair->sender = sender;
+            pair->receiver = receiver;
+            pair_index = batch->pair_cnt++;
+            buckets[bucket] = pair_index;
+
+            // 해시가 절반 넘게 차면 두 배로 늘려 다시 배치
+            if (batch->pair_cnt * 2 > bucket_cnt) {
+                free(buckets);
+                bucket_cnt *= 2;
+                buckets = (int*)malloc(sizeof(int) * bucket_cnt);
+                for (int i = 0; i < bucket_cnt; i++) {
+                    buckets[i] = -1;
+                }
+                for (int p = 0; p < batch->pair_cnt; p++) {
+                    unsigned long long k = ((unsigned long long)(unsigned)batch->pairs[p].sender << 32) | (unsigned)batch->pairs[p].receiver;
+                    size_t b = (size_t)((k * 0x9E3779B97F4A7C15ULL) >> 40) & (bucket_cnt - 1);
+                    while (buckets[b] >= 0) {
+                        b = (b + 1) & (bucket_cnt - 1);
+                    }
+                    buckets[b] = p;
+                }
+            }
+        }
+
+        if (batch->message_cnt == message_cap) {
+            message_cap *= 2;
+            batch->messages = (Message*)realloc(batch->messages, sizeof(Message) * message_cap);
+        }
+        Message* message = &batch->messages[batch->message_cnt++];
+        message->pair = pair_index;
+        message->body = body;
+        message->body_len = body_len;
+        scanner.pos = body + body_len;
+        scanner.line += end != NULL;
+    }
+    free(buckets);
+    return 0;
+}
+
+static inline void message_batch_free(MessageBatch* batch) {
+    for (int p = 0; p < batch->pair_cnt; p++) {
+        free(batch->pairs[p].hops);
+        free(batch->pairs[p].text);
+    }
+    free(batch->pairs);
+    free(batch->messages);
+    input_close(&batch->input);
+}
+
+static inline void message_pair_append(MessagePair* pair, const char* text, size_t len) {
+    if (pair->text_len + len > pair->text_cap) {
+        pair->text_cap = (pair->text_len + len) * 2;
+        pair->text = (char*)realloc(pair->text, pair->text_cap);
+    }
+    memcpy(pair->text + pair->text_len, text, len);
+    pair->text_len += len;
+}
+
+// 만들어 둔 text가 지금 라우팅 정보에서도 같은지 확인 (거리와 경로상의 다음 홉들만 비교)
+static inline int message_pair_current(const MessagePair* pair, const RouteView* view) {
+    if (!pair->valid) {
+        return 0;
+    }
+    if (view->dist(view->ctx, pair->sender, pair->receiver) != pair->distance) {
+        return 0;
+    }
+    for (int i = 0; i < pair->hop_cnt; i++) {
+        int expected = i + 1 < pair->hop_cnt ? pair->hops[i + 1] : pair->receiver;
+        if (view->next(view->ctx, pair->hops[i], pair->receiver) != (uint32_t)expected) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// 경로를 따라가며 text를 다시 만듦 (경로상의 라우터마다 자기 테이블의 다음 홉을 따라감)
+static inline void message_pair_build(MessagePair* pair, const RouteView* view) {
+    char number[64];
+    int len;
+
+    pair->text_len = 0;
+    pair->hop_cnt = 0;
+    len = snprintf(number, sizeof(number), "from %d to %d cost ", pair->sender, pair->receiver);
+    message_pair_append(pair, number, (size_t)len);
+
+    pair->distance = view->dist(view->ctx, pair->sender, pair->receiver);
+    if (pair->distance != ROUTE_NONE) {
+        len = snprintf(number, sizeof(number), "%u hops ", pair->distance);
+        message_pair_append(pair, number, (size_t)len);
+        int hop = pair->sender;
+        while (1) {
+            if (pair->hop_cnt == pair->hop_cap) {
+                pair->hop_cap = pair->hop_cap ? pair->hop_cap * 2 : 8;
+                pair->hops = (int*)realloc(pair->hops, sizeof(int) * pair->hop_cap);
+            }
+            pair->hops[pair->hop_cnt++] = hop;
+            len = snprintf(number, sizeof(number), "%d ", hop);
+            message_pair_append(pair, number, (size_t)len);
+            uint32_t next = view->next(view->ctx, hop, pair->receiver);
+            if (next == (uint32_t)pair->receiver) {
+                break;
+            }
+            // 수렴하지 못한 테이블(distvec sim)에는 루프가 남을 수 있음 - 노드 수만큼 따라가면 멈춤
+            if (next == ROUTE_NONE || pair->hop_cnt >= view->node_cnt) {
+                message_pair_append(pair, "loop ", 5);
+                break;
+            }
+            hop = (int)next;
+        }
+    } else {
+        const char* unreachable = "infinite hops unreachable ";
+        message_pair_append(pair, unreachable, strlen(unreachable));
+    }
+    message_pair_append(pair, "message ", 8);
+    pair->valid = 1;
+}
+
+// 변경 사항 하나의 메시지 출력 - sender_to_reciever와 같은 형식
+static inline void message_batch_write(OutBuf* out, MessageBatch* batch, const RouteView* view) {
+    for (int p = 0; p < batch->pair_cnt; p++) {
+        if (!message_pair_current(&batch->pairs[p], view)) {
+            message_pair_build(&batch->pairs[p], view);
+        }
+    }
+    for (int i = 0; i < batch->message_cnt; i++) {
+        const Message* message = &batch->messages[i];
+        const MessagePair* pair = &batch->pairs[message->pair];
+        out_bytes(out, pair->text, pair->text_len);
+        out_bytes(out, message->body, message->body_len);
+    }
+    out_char(out, '\n'); // 파일 끝에 개행 문자 추가
+}
+
+#endif
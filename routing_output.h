@@ -0,0 +1,212 @@
+#ifndef ROUTING_OUTPUT_H
+#define ROUTING_OUTPUT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "routing_table.h"
+
+#define OUT_BUFFER_SIZE (1 << 20)   // 출력 버퍼 크기 (가득 차거나 변경 사항이 끝날 때 한 번에 기록)
+
+// 출력 버퍼 - 라우팅 테이블과 메시지 출력을 모아 fwrite 한 번으로 기록
+// 정수는 printf 대신 두 자리씩 표를 찾아 직접 씀 (to_chars 방식)
+// delta 모드(-d)에서는 라우팅 테이블을 지난번 출력과 비교해 바뀐 칸만 씀
+//   "라우터 목적지 다음홉 거리" (도달 가능), "라우터 목적지 unreachable" (도달 불가가 된 칸), 끝에 빈 줄
+//   처음 출력은 모든 칸이 도달 불가였던 것과 비교하므로 도달 가능한 칸 전체
+typedef struct OutBuf_ {
+    FILE* file;
+    char* data;
+    size_t len;
+    size_t cap;
+    uint64_t written;       // 파일에 기록한 바이트 수
+    int delta;              // 1이면 라우팅 테이블은 바뀐 칸만 출력
+    int node_cnt;           // delta: 지난번에 출력한 테이블의 노드 수
+    uint32_t* last_dist;    // delta: 지난번에 출력한 거리 / 다음 홉 (도달 불가는 ROUTE_NONE)
+    uint32_t* last_next;
+} OutBuf;
+
+static const char out_digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static inline void out_init(OutBuf* out, FILE* file, int delta) {
+    out->file = file;
+    out->cap = OUT_BUFFER_SIZE;
+    out->data = (char*)malloc(out->cap);
+    out->len = 0;
+    out->written = 0;
+    out->delta = delta;
+    out->node_cnt = 0;
+    out->last_dist = NULL;
+    out->last_next = NULL;
+}
+
+// 버퍼 내용을 파일에 기록 (파일 버퍼까지 비움)
+static inline void out_flush(OutBuf* out) {
+    if (out->len > 0) {
+        fwrite(out->data, 1, out->len, out->file);
+        out->written += out->len;
+        out->len = 0;
+    }
+    fflush(out->file);
+}
+
+// 지금까지 출력한 바이트 수 (버퍼에 남은 것 포함)
+static inline uint64_t out_total(const OutBuf* out) {
+    return out->written + out->len;
+}
+
+static inline void out_free(OutBuf* out) {
+    out_flush(out);
+    free(out->data);
+    free(out->last_dist);
+    free(out->last_next);
+    out->data = NULL;
+    out->last_dist = out->last_next = NULL;
+}
+
+static inline void out_bytes(OutBuf* out, const char* text, size_t len) {
+    if (len > out->cap - out->len) {
+        fwrite(out->data, 1, out->len, out->file);
+        out->written += out->len;
+        out->len = 0;
+        if (len >= out->cap) {
+            fwrite(text, 1, len, out->file);    // 버퍼보다 큰 조각은 바로 기록
+            out->written += len;
+            return;
+        }
+    }
+    memcpy(out->data + out->len, text, len);
+    out->len += len;
+}
+
+static inline void out_char(OutBuf* out, char c) {
+    if (out->len == out->cap) {
+        fwrite(out->data, 1, out->len, out->file);
+        out->written += out->len;
+        out->len = 0;
+    }
+    out->data[out->len++] = c;
+}
+
+static inline void out_u32(OutBuf* out, uint32_t value) {
+    char digits[10];
+    char* p = digits + sizeof(digits);
+    while (value >= 100) {
+        uint32_t pair = value % 100;
+        value /= 100;
+        p -= 2;
+        memcpy(p, out_digit_pairs + pair * 2, 2);
+    }
+    if (value >= 10) {
+        p -= 2;
+        memcpy(p, out_digit_pairs + value * 2, 2);
+    } else {
+        *--p = (char)('0' + value);
+    }
+    out_bytes(out, p, (size_t)(digits + sizeof(digits) - p));
+}
+
+// "목적지 다음홉 거리" 한 줄
+static inline void out_route_line(OutBuf* out, uint32_t destination, uint32_t next, uint32_t distance) {
+    out_u32(out, destination);
+    out_char(out, ' ');
+    out_u32(out, next);
+    out_char(out, ' ');
+    out_u32(out, distance);
+    out_char(out, '\n');
+}
+
+// 라우팅 테이블 전체 출력 - 라우터마다 도달 가능한 목적지 줄들과 빈 줄 (net_print 형식)
+template <typename T>
+static inline void out_table_rows(OutBuf* out, const RouteTable* table) {
+    int node_cnt = table->node_cnt;
+    const T* dist = (const T*)table->dist;
+    const T* next = (const T*)table->next;
+    for (int i = 0; i < node_cnt; i++) {
+        size_t row = (size_t)i * node_cnt;
+        for (int j = 0; j < node_cnt; j++) {
+            if (dist[row + j] != route_infinity<T>()) {
+                out_route_line(out, (uint32_t)j, next[row + j], dist[row + j]);
+            }
+        }
+        out_char(out, '\n');
+    }
+}
+
+// 지난번 출력과 달라진 칸만 출력하고 기억해 둠
+static inline void out_routes_delta(OutBuf* out, const RouteView* view) {
+    int node_cnt = view->node_cnt;
+    size_t cells = (size_t)node_cnt * node_cnt;
+    if (out->node_cnt != node_cnt || !out->last_dist) {
+        free(out->last_dist);
+        free(out->last_next);
+        out->node_cnt = node_cnt;
+        out->last_dist = (uint32_t*)malloc(sizeof(uint32_t) * (cells > 0 ? cells : 1));
+        out->last_next = (uint32_t*)malloc(sizeof(uint32_t) * (cells > 0 ? cells : 1));
+        for (size_t c = 0; c < cells; c++) {
+            out->last_dist[c] = ROUTE_NONE;
+            out->last_next[c] = ROUTE_NONE;
+        }
+    }
+    for (int i = 0; i < node_cnt; i++) {
+        size_t row = (size_t)i * node_cnt;
+        for (int j = 0; j < node_cnt; j++) {
+            uint32_t distance = view->dist(view->ctx, i, j);
+            uint32_t next = distance == ROUTE_NONE ? ROUTE_NONE : view->next(view->ctx, i, j);
+            if (distance == out->last_dist[row + j] && next == out->last_next[row + j]) {
+                continue;
+            }
+            out->last_dist[row + j] = distance;
+            out->last_next[row + j] = next;
+            out_u32(out, (uint32_t)i);
+            out_char(out, ' ');
+            if (distance == ROUTE_NONE) {
+                out_u32(out, (uint32_t)j);
+                out_bytes(out, " unreachable\n", 13);
+            } else {
+                out_route_line(out, (uint32_t)j, next, distance);
+            }
+        }
+    }
+    out_char(out, '\n');
+}
+
+// 라우팅 정보 출력 (전체 또는 delta)
+static inline void out_routes(OutBuf* out, const RouteView* view) {
+    if (out->delta) {
+        out_routes_delta(out, view);
+        return;
+    }
+    for (int i = 0; i < view->node_cnt; i++) {
+        for (int j = 0; j < view->node_cnt; j++) {
+            uint32_t distance = view->dist(view->ctx, i, j);
+            if (distance != ROUTE_NONE) {
+                out_route_line(out, (uint32_t)j, view->next(view->ctx, i, j), distance);
+            }
+        }
+        out_char(out, '\n');
+    }
+}
+
+// 라우팅 테이블 출력 - 전체 출력은 배열을 직접 읽음
+static inline void out_route_table(OutBuf* out, const RouteTable* table) {
+    if (out->delta) {
+        RouteView view = route_view_table(table);
+        out_routes_delta(out, &view);
+    } else if (table->compact) {
+        out_table_rows<uint16_t>(out, table);
+    } else {
+        out_table_rows<uint32_t>(out, table);
+    }
+}
+
+#endif
@@ -0,0 +1,192 @@
+#ifndef ROUTING_POOL_H
+#define ROUTING_POOL_H
+
+#include <stdlib.h>
+#include <pthread.h>
+
+// 작업 훔치기(work stealing) 스레드 풀
+// pool_run은 [0, count) 작업을 스레드 수만큼 연속 구간으로 나눠 각 스레드의 덱에 넣고,
+// 자기 구간을 앞에서부터 처리하다 비면 다른 스레드 구간의 뒤쪽 절반을 훔쳐 옴
+// 호출한 스레드도 0번 작업자로 참여하므로 스레드 수가 1이면 추가 스레드 없이 순서대로 실행
+
+typedef void (*PoolTask)(void* ctx, int worker, int index);
+
+typedef struct PoolDeque_ {
+    pthread_mutex_t lock;
+    int begin;          // 남은 작업 구간 [begin, end)
+    int end;
+} PoolDeque;
+
+typedef struct WorkerPool_ WorkerPool;
+
+typedef struct PoolWorker_ {
+    WorkerPool* pool;
+    int id;
+} PoolWorker;
+
+struct WorkerPool_ {
+    int thread_cnt;
+    pthread_t* threads;
+    PoolWorker* workers;
+    PoolDeque* deques;
+    pthread_mutex_t mutex;
+    pthread_cond_t start_cond;
+    pthread_cond_t done_cond;
+    int generation;     // pool_run 호출마다 증가
+    int busy;           // 아직 작업 중인 보조 스레드 수
+    int shutdown;
+    PoolTask task;
+    void* ctx;
+};
+
+// 자기 덱의 앞에서 작업 하나를 꺼냄
+static inline int pool_take(PoolDeque* deque, int* index) {
+    int found = 0;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->begin < deque->end) {
+        *index = deque->begin++;
+        found = 1;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+// 다른 스레드 덱의 뒤쪽 절반을 훔쳐 자기 덱에 넣음
+static inline int pool_steal(WorkerPool* pool, int worker) {
+    for (int k = 1; k < pool->thread_cnt; k++) {
+        PoolDeque* victim = &pool->deques[(worker + k) % pool->thread_cnt];
+        int begin = 0, end = 0;
+        pthread_mutex_lock(&victim->lock);
+        int left = victim->end - victim->begin;
+        if (left > 0) {
+            end = victim->end;
+            begin = end - (left + 1) / 2;
+            victim->end = begin;
+        }
+        pthread_mutex_unlock(&victim->lock);
+        if (end > begin) {
+            PoolDeque* own = &pool->deques[worker];
+            pthread_mutex_lock(&own->lock);
+            own->begin = begin;
+            own->end = end;
+            pthread_mutex_unlock(&own->lock);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// 작업이 모두 사라질 때까지 처리 (새 작업은 생기지 않으므로 모든 덱이 비면 끝)
+static inline void pool_drain(WorkerPool* pool, int worker) {
+    int index;
+    for (;;) {
+        while (pool_take(&pool->deques[worker], &index)) {
+            pool->task(pool->ctx, worker, index);
+        }
+        if (!pool_steal(pool, worker)) {
+            break;
+        }
+    }
+}
+
+static inline void* pool_thread_main(void* arg) {
+    PoolWorker* self = (PoolWorker*)arg;
+    WorkerPool* pool = self->pool;
+    int seen = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&pool->mutex);
+        while (pool->generation == seen && !pool->shutdown) {
+            pthread_cond_wait(&pool->start_cond, &pool->mutex);
+        }
+        if (pool->shutdown) {
+            pthread_mutex_unlock(&pool->mutex);
+            break;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->mutex);
+
+        pool_drain(pool, self->id);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->busy == 0) {
+            pthread_cond_signal(&pool->done_cond);
+        }
+        pthread_mutex_unlock(&pool->mutex);
+    }
+    return NULL;
+}
+
+static inline void pool_init(WorkerPool* pool, int thread_cnt) {
+    pool->thread_cnt = thread_cnt < 1 ? 1 : thread_cnt;
+    pool->threads = (pthread_t*)malloc(sizeof(pthread_t) * pool->thread_cnt);
+    pool->workers = (PoolWorker*)malloc(sizeof(PoolWorker) * pool->thread_cnt);
+    pool->deques = (PoolDeque*)malloc(sizeof(PoolDeque) * pool->thread_cnt);
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->start_cond, NULL);
+    pthread_cond_init(&pool->done_cond, NULL);
+    pool->generation = 0;
+    pool->busy = 0;
+    pool->shutdown = 0;
+
+    for (int i = 0; i < pool->thread_cnt; i++) {
+        pthread_mutex_init(&pool->deques[i].lock, NULL);
+        pool->deques[i].begin = pool->deques[i].end = 0;
+        pool->workers[i].pool = pool;
+        pool->workers[i].id = i;
+    }
+    for (int i = 1; i < pool->thread_cnt; i++) {
+        pthread_create(&pool->threads[i], NULL, pool_thread_main, &pool->workers[i]);
+    }
+}
+
+static inline void pool_free(WorkerPool* pool) {
+    pthread_mutex_lock(&pool->mutex);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->start_cond);
+    pthread_mutex_unlock(&pool->mutex);
+    for (int i = 1; i < pool->thread_cnt; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    for (int i = 0; i < pool->thread_cnt; i++) {
+        pthread_mutex_destroy(&pool->deques[i].lock);
+    }
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->start_cond);
+    pthread_cond_destroy(&pool->done_cond);
+    free(pool->threads);
+    free(pool->workers);
+    free(pool->deques);
+}
+
+// task(ctx, worker, index)를 index = 0 .. count - 1에 대해 실행하고 모두 끝날 때까지 기다림
+// worker(0 .. thread_cnt - 1)는 스레드별 작업 공간을 고르는 데 사용
+static inline void pool_run(WorkerPool* pool, int count, PoolTask task, void* ctx) {
+    int thread_cnt = pool->thread_cnt;
+    for (int i = 0; i < thread_cnt; i++) {
+        pool->deques[i].begin = (int)((long long)count * i / thread_cnt);
+        pool->deques[i].end = (int)((long long)count * (i + 1) / thread_cnt);
+    }
+    pool->task = task;
+    pool->ctx = ctx;
+    if (thread_cnt == 1) {
+        pool_drain(pool, 0);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->busy = thread_cnt - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start_cond);
+    pthread_mutex_unlock(&pool->mutex);
+
+    pool_drain(pool, 0);
+
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->busy > 0) {
+        pthread_cond_wait(&pool->done_cond, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+#endif
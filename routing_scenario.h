@@ -0,0 +1,192 @@
+#ifndef ROUTING_SCENARIO_H
+#define ROUTING_SCENARIO_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "routing_graph.h"
+
+// 고장 시나리오 (--what-if) - 기본 토폴로지에서 링크나 노드가 고장 났을 때 경로가 어떻게 바뀌는지 요약
+// 시나리오 파일은 한 줄에 시나리오 하나, "link U V"와 "node X"를 여러 개 적으면 동시에 고장 (#부터 줄 끝은 주석)
+// links / nodes를 주면 모든 단일 링크 고장 / 모든 단일 노드 고장을 차례로 만듦
+// 요약은 원래 경로와 비교해 고장 난 노드를 뺀 (출발점, 목적지) 쌍마다 센 값
+
+// 고장 하나 - v가 음수면 노드 u, 아니면 링크 (u, v)
+typedef struct Failure_ {
+    int u;
+    int v;
+} Failure;
+
+// 시나리오 하나 - failures[first] ~ failures[first + cnt - 1]
+typedef struct Scenario_ {
+    int first;
+    int cnt;
+} Scenario;
+
+typedef struct ScenarioList_ {
+    Failure* failures;
+    int failure_cnt;
+    int failure_cap;
+    Scenario* scenarios;
+    int scenario_cnt;
+    int scenario_cap;
+} ScenarioList;
+
+typedef struct ScenarioResult_ {
+    int sources;            // 경로를 다시 계산한 출발점 수 (나머지 출발점은 원래 경로를 그대로 씀)
+    long long unreachable;  // 원래 도달할 수 있었는데 끊긴 쌍
+    long long next_changed; // 아직 도달할 수 있지만 다음 홉이 바뀐 쌍
+    long long rerouted;     // 거리가 늘어난 쌍
+    long long stretched;    // 그중 원래 거리가 0보다 큰 쌍 (비용 0인 링크로만 이어졌던 쌍은 비율이 없어 stretch에서 뺌)
+    double stretch_sum;     // stretched 쌍의 (새 거리 / 원래 거리) 합
+    double stretch_max;
+} ScenarioResult;
+
+static inline void scenario_list_init(ScenarioList* list) {
+    list->failure_cap = 64;
+    list->scenario_cap = 64;
+    list->failures = (Failure*)malloc(sizeof(Failure) * list->failure_cap);
+    list->scenarios = (Scenario*)malloc(sizeof(Scenario) * list->scenario_cap);
+    list->failure_cnt = 0;
+    list->scenario_cnt = 0;
+}
+
+static inline void scenario_list_free(ScenarioList* list) {
+    free(list->failures);
+    free(list->scenarios);
+    list->failures = NULL;
+    list->scenarios = NULL;
+    list->failure_cnt = list->scenario_cnt = 0;
+}
+
+// 새 시나리오 시작 (이후 scenario_add_failure로 고장을 붙임)
+static inline void scenario_begin(ScenarioList* list) {
+    if (list->scenario_cnt == list->scenario_cap) {
+        list->scenario_cap *= 2;
+        list->scenarios = (Scenario*)realloc(list->scenarios, sizeof(Scenario) * list->scenario_cap);
+    }
+    Scenario* scenario = &list->scenarios[list->scenario_cnt++];
+    scenario->first = list->failure_cnt;
+    scenario->cnt = 0;
+}
+
+static inline void scenario_add_failure(ScenarioList* list, int u, int v) {
+    if (list->failure_cnt == list->failure_cap) {
+        list->failure_cap *= 2;
+        list->failures = (Failure*)realloc(list->failures, sizeof(Failure) * list->failure_cap);
+    }
+    list->failures[list->failure_cnt].u = u;
+    list->failures[list->failure_cnt].v = v;
+    list->failure_cnt++;
+    list->scenarios[list->scenario_cnt - 1].cnt++;
+}
+
+// 모든 단일 링크 고장 (링크마다 한 번, 작은 번호 노드 순서)
+static inline void scenario_list_links(ScenarioList* list, const Graph* graph) {
+    for (int u = 0; u < graph->node_cnt; u++) {
+        for (int v = u + 1; v < graph->node_cnt; v++) {
+            if (graph_find(graph, u, v) >= 0) {
+                scenario_begin(list);
+                scenario_add_failure(list, u, v);
+            }
+        }
+    }
+}
+
+// 모든 단일 노드 고장
+static inline void scenario_list_nodes(ScenarioList* list, int node_cnt) {
+    for (int x = 0; x < node_cnt; x++) {
+        scenario_begin(list);
+        scenario_add_failure(list, x, -1);
+    }
+}
+
+// 시나리오 파일 읽기 - 없는 링크, 범위를 벗어난 노드, 알 수 없는 단어는 줄 번호와 함께 오류를 알리고 -1
+static inline int scenario_list_load(ScenarioList* list, FILE* file, const Graph* graph) {
+    char buf[4096];
+    int line = 0;
+    while (fgets(buf, sizeof(buf), file)) {
+        line++;
+        char* comment = strchr(buf, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+        int begun = 0;
+        char* save = NULL;
+        for (char* word = strtok_r(buf, " \t\r\n", &save); word; word = strtok_r(NULL, " \t\r\n", &save)) {
+            int is_link = strcmp(word, "link") == 0;
+            if (!is_link && strcmp(word, "node") != 0) {
+                printf("Error: scenarios line %d: unknown failure %s\n", line, word);
+                return -1;
+            }
+            int nodes[2] = {-1, -1};
+            for (int k = 0; k < (is_link ? 2 : 1); k++) {
+                char* number = strtok_r(NULL, " \t\r\n", &save);
+                char* end = NULL;
+                nodes[k] = number ? (int)strtol(number, &end, 10) : -1;
+                if (!number || *end != '\0' || nodes[k] < 0 || nodes[k] >= graph->node_cnt) {
+                    printf("Error: scenarios line %d: %s needs node numbers in 0-%d\n", line, word, graph->node_cnt - 1);
+                    return -1;
+                }
+            }
+            if (is_link && graph_find(graph, nodes[0], nodes[1]) < 0) {
+                printf("Error: scenarios line %d: no link %d %d in topology\n", line, nodes[0], nodes[1]);
+                return -1;
+            }
+            if (!begun) {
+                scenario_begin(list);
+                begun = 1;
+            }
+            scenario_add_failure(list, nodes[0], nodes[1]);
+        }
+    }
+    return 0;
+}
+
+// 출발점 하나의 새 경로(dist, next)를 원래 경로와 비교해 result에 더함 (failed: 고장 난 노드 표시)
+static inline void scenario_compare_row(ScenarioResult* result, const int* base_dist, const int* base_next,
+                                        const int* dist, const int* next, const char* failed, int start, int node_cnt) {
+    result->sources++;
+    for (int d = 0; d < node_cnt; d++) {
+        if (d == start || failed[d] || base_dist[d] >= ROUTE_INFINITY) {
+            continue;
+        }
+        if (dist[d] >= ROUTE_INFINITY) {
+            result->unreachable++;
+            continue;
+        }
+        if (next[d] != base_next[d]) {
+            result->next_changed++;
+        }
+        if (dist[d] > base_dist[d]) {
+            result->rerouted++;
+            if (base_dist[d] == 0) {
+                continue;
+            }
+            double stretch = (double)dist[d] / base_dist[d];
+            result->stretched++;
+            result->stretch_sum += stretch;
+            if (stretch > result->stretch_max) {
+                result->stretch_max = stretch;
+            }
+        }
+    }
+}
+
+// 시나리오 요약 한 줄 "link 3 7 node 5: sources 12 unreachable 0 next_changed 40 rerouted 18 stretch_avg 1.083 stretch_max 1.500"
+static inline void scenario_write(FILE* file, const ScenarioList* list, int k, const ScenarioResult* result) {
+    const Scenario* scenario = &list->scenarios[k];
+    for (int i = 0; i < scenario->cnt; i++) {
+        const Failure* failure = &list->failures[scenario->first + i];
+        if (failure->v < 0) {
+            fprintf(file, "%snode %d", i ? " " : "", failure->u);
+        } else {
+            fprintf(file, "%slink %d %d", i ? " " : "", failure->u, failure->v);
+        }
+    }
+    fprintf(file, ": sources %d unreachable %lld next_changed %lld rerouted %lld stretch_avg %.3f stretch_max %.3f\n",
+            result->sources, result->unreachable, result->next_changed, result->rerouted,
+            result->stretched ? result->stretch_sum / result->stretched : 1.0, result->stretched ? result->stretch_max : 1.0);
+}
+
+#endif
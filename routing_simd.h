@@ -0,0 +1,177 @@
+#ifndef ROUTING_SIMD_H
+#define ROUTING_SIMD_H
+
+#include <stdint.h>
+#include "routing_graph.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ROUTING_SIMD_X86 1
+#endif
+
+// min-plus 행 갱신 커널
+// d = 0 .. n - 1에 대해 route_add(via[d], link) < dist[d]이면 dist[d]를 줄이고 next[d] = hop
+// 반환 값: 바뀐 칸 수
+// 칸끼리 서로 의존하지 않으므로 벡터로 한 번에 처리하고, 바뀐 칸 마스크로 다음 홉과 개수를 갱신
+// AVX2 / SSE4.1 / 스칼라 중 CPU가 지원하는 것을 실행 시점에 한 번 골라 사용
+
+template <typename T>
+static inline int relax_row_scalar(T* dist, T* next, const T* via, T link, T hop, int n) {
+    int changed = 0;
+    for (int d = 0; d < n; d++) {
+        T new_distance = route_add(via[d], link);
+        if (new_distance < dist[d]) {
+            dist[d] = new_distance;
+            next[d] = hop;
+            changed++;
+        }
+    }
+    return changed;
+}
+
+#ifdef ROUTING_SIMD_X86
+
+// uint32_t에는 포화 덧셈이 없으므로 넘친 칸(합 < via)을 찾아 무한대(모든 비트 1)로 만듦
+// 부호 없는 비교는 min과 cmpeq로: a <= b  <=>  min(a, b) == a
+
+__attribute__((target("avx2")))
+static int relax_row_u32_avx2(uint32_t* dist, uint32_t* next, const uint32_t* via, uint32_t link, uint32_t hop, int n) {
+    const __m256i ones = _mm256_set1_epi32(-1);
+    const __m256i vlink = _mm256_set1_epi32((int)link);
+    const __m256i vhop = _mm256_set1_epi32((int)hop);
+    int changed = 0;
+    int d = 0;
+    for (; d + 8 <= n; d += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(via + d));
+        __m256i cur = _mm256_loadu_si256((const __m256i*)(dist + d));
+        __m256i sum = _mm256_add_epi32(v, vlink);
+        __m256i no_wrap = _mm256_cmpeq_epi32(_mm256_min_epu32(v, sum), v);
+        sum = _mm256_or_si256(sum, _mm256_andnot_si256(no_wrap, ones));
+        __m256i le = _mm256_cmpeq_epi32(_mm256_min_epu32(sum, cur), sum);
+        __m256i mask = _mm256_andnot_si256(_mm256_cmpeq_epi32(sum, cur), le);
+        int bits = _mm256_movemask_ps(_mm256_castsi256_ps(mask));
+        if (bits) {
+            __m256i nx = _mm256_loadu_si256((const __m256i*)(next + d));
+            _mm256_storeu_si256((__m256i*)(dist + d), _mm256_blendv_epi8(cur, sum, mask));
+            _mm256_storeu_si256((__m256i*)(next + d), _mm256_blendv_epi8(nx, vhop, mask));
+            changed += __builtin_popcount(bits);
+        }
+    }
+    return changed + relax_row_scalar<uint32_t>(dist + d, next + d, via + d, link, hop, n - d);
+}
+
+__attribute__((target("avx2")))
+static int relax_row_u16_avx2(uint16_t* dist, uint16_t* next, const uint16_t* via, uint16_t link, uint16_t hop, int n) {
+    const __m256i vlink = _mm256_set1_epi16((short)link);
+    const __m256i vhop = _mm256_set1_epi16((short)hop);
+    int changed = 0;
+    int d = 0;
+    for (; d + 16 <= n; d += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(via + d));
+        __m256i cur = _mm256_loadu_si256((const __m256i*)(dist + d));
+        __m256i sum = _mm256_adds_epu16(v, vlink);
+        __m256i le = _mm256_cmpeq_epi16(_mm256_min_epu16(sum, cur), sum);
+        __m256i mask = _mm256_andnot_si256(_mm256_cmpeq_epi16(sum, cur), le);
+        int bits = _mm256_movemask_epi8(mask);
+        if (bits) {
+            __m256i nx = _mm256_loadu_si256((const __m256i*)(next + d));
+            _mm256_storeu_si256((__m256i*)(dist + d), _mm256_blendv_epi8(cur, sum, mask));
+            _mm256_storeu_si256((__m256i*)(next + d), _mm256_blendv_epi8(nx, vhop, mask));
+            changed += __builtin_popcount((unsigned)bits) / 2;
+        }
+    }
+    return changed + relax_row_scalar<uint16_t>(dist + d, next + d, via + d, link, hop, n - d);
+}
+
+__attribute__((target("sse4.1")))
+static int relax_row_u32_sse(uint32_t* dist, uint32_t* next, const uint32_t* via, uint32_t link, uint32_t hop, int n) {
+    const __m128i ones = _mm_set1_epi32(-1);
+    const __m128i vlink = _mm_set1_epi32((int)link);
+    const __m128i vhop = _mm_set1_epi32((int)hop);
+    int changed = 0;
+    int d = 0;
+    for (; d + 4 <= n; d += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(via + d));
+        __m128i cur = _mm_loadu_si128((const __m128i*)(dist + d));
+        __m128i sum = _mm_add_epi32(v, vlink);
+        __m128i no_wrap = _mm_cmpeq_epi32(_mm_min_epu32(v, sum), v);
+        sum = _mm_or_si128(sum, _mm_andnot_si128(no_wrap, ones));
+        __m128i le = _mm_cmpeq_epi32(_mm_min_epu32(sum, cur), sum);
+        __m128i mask = _mm_andnot_si128(_mm_cmpeq_epi32(sum, cur), le);
+        int bits = _mm_movemask_ps(_mm_castsi128_ps(mask));
+        if (bits) {
+            __m128i nx = _mm_loadu_si128((const __m128i*)(next + d));
+            _mm_storeu_si128((__m128i*)(dist + d), _mm_blendv_epi8(cur, sum, mask));
+            _mm_storeu_si128((__m128i*)(next + d), _mm_blendv_epi8(nx, vhop, mask));
+            changed += __builtin_popcount(bits);
+        }
+    }
+    return changed + relax_row_scalar<uint32_t>(dist + d, next + d, via + d, link, hop, n - d);
+}
+
+__attribute__((target("sse4.1")))
+static int relax_row_u16_sse(uint16_t* dist, uint16_t* next, const uint16_t* via, uint16_t link, uint16_t hop, int n) {
+    const __m128i vlink = _mm_set1_epi16((short)link);
+    const __m128i vhop = _mm_set1_epi16((short)hop);
+    int changed = 0;
+    int d = 0;
+    for (; d + 8 <= n; d += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(via + d));
+        __m128i cur = _mm_loadu_si128((const __m128i*)(dist + d));
+        __m128i sum = _mm_adds_epu16(v, vlink);
+        __m128i le = _mm_cmpeq_epi16(_mm_min_epu16(sum, cur), sum);
+        __m128i mask = _mm_andnot_si128(_mm_cmpeq_epi16(sum, cur), le);
+        int bits = _mm_movemask_epi8(mask);
+        if (bits) {
+            __m128i nx = _mm_loadu_si128((const __m128i*)(next + d));
+            _mm_storeu_si128((__m128i*)(dist + d), _mm_blendv_epi8(cur, sum, mask));
+            _mm_storeu_si128((__m128i*)(next + d), _mm_blendv_epi8(nx, vhop, mask));
+            changed += __builtin_popcount((unsigned)bits) / 2;
+        }
+    }
+    return changed + relax_row_scalar<uint16_t>(dist + d, next + d, via + d, link, hop, n - d);
+}
+
+#endif
+
+typedef int (*RelaxRowU32)(uint32_t* dist, uint32_t* next, const uint32_t* via, uint32_t link, uint32_t hop, int n);
+typedef int (*RelaxRowU16)(uint16_t* dist, uint16_t* next, const uint16_t* via, uint16_t link, uint16_t hop, int n);
+
+static inline RelaxRowU32 relax_row_select_u32() {
+#ifdef ROUTING_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return relax_row_u32_avx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return relax_row_u32_sse;
+    }
+#endif
+    return relax_row_scalar<uint32_t>;
+}
+
+static inline RelaxRowU16 relax_row_select_u16() {
+#ifdef ROUTING_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return relax_row_u16_avx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return relax_row_u16_sse;
+    }
+#endif
+    return relax_row_scalar<uint16_t>;
+}
+
+// 테이블 자료형에 맞는 커널 호출 (처음 호출할 때 고른 커널을 계속 사용)
+static inline int relax_row(uint32_t* dist, uint32_t* next, const uint32_t* via, uint32_t link, uint32_t hop, int n) {
+    static const RelaxRowU32 kernel = relax_row_select_u32();
+    return kernel(dist, next, via, link, hop, n);
+}
+
+static inline int relax_row(uint16_t* dist, uint16_t* next, const uint16_t* via, uint16_t link, uint16_t hop, int n) {
+    static const RelaxRowU16 kernel = relax_row_select_u16();
+    return kernel(dist, next, via, link, hop, n);
+}
+
+#endif
@@ -0,0 +1,247 @@
+#ifndef ROUTING_SNAPSHOT_H
+#define ROUTING_SNAPSHOT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "routing_input.h"
+#include "routing_table.h"
+
+// 계산이 끝난 라우팅 테이블의 바이너리 스냅샷 (--save-snapshot / --load-snapshot)
+// 파일은 헤더, 적용한 변경 사항 목록, 라우팅 테이블 블록(RouteTable과 같은 배치: 거리 배열 뒤에 다음 홉 배열),
+// 엔진별 추가 배열(동적 엔진의 best)로 이루어지고 각 구간은 64바이트 경계에서 시작
+// 키는 토폴로지 내용의 해시에 변경 사항들을 이어서 해시한 값 - 읽을 때 지금 입력으로 다시 계산해 맞을 때만 사용
+// 읽기는 파일을 mmap해서 헤더만 확인하고 테이블 블록을 그대로 복사 (텍스트 파싱 없음)
+// 같은 프로그램, 같은 엔진이 쓴 스냅샷만 받음 (엔진마다 같은 비용 경로의 다음 홉 선택이 다를 수 있음)
+
+#define SNAPSHOT_MAGIC "RTSNAP\r\n"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_ALIGN 64
+
+typedef struct SnapshotHeader_ {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    char program[16];
+    char engine[16];
+    uint64_t topology_hash;     // 토폴로지의 노드 수와 링크 목록(파일 순서)의 FNV-1a
+    uint64_t key;               // topology_hash에 변경 사항들을 차례로 이어서 해시
+    int32_t node_cnt;
+    int32_t compact;            // 테이블 칸이 uint16_t면 1
+    int32_t max_weight;
+    int32_t change_cnt;         // 테이블에 반영된 변경 사항 수
+    uint64_t changes_offset;    // 변경 사항 (int32 src, dst, cost) * change_cnt
+    uint64_t table_offset;
+    uint64_t table_bytes;
+    uint64_t aux_offset;        // 엔진별 추가 int32 배열 node_cnt * node_cnt (없으면 0)
+    uint64_t file_size;
+} SnapshotHeader;
+
+// mmap한 스냅샷
+typedef struct RouteSnapshot_ {
+    void* base;
+    size_t size;
+    const SnapshotHeader* header;
+    RouteTable table;           // 매핑된 테이블 블록을 가리킴 (해제하지 않음)
+    const int32_t* changes;
+    const int32_t* aux;         // 없으면 NULL
+} RouteSnapshot;
+
+static inline uint64_t snapshot_hash_int(uint64_t hash, int32_t value) {
+    uint32_t bits = (uint32_t)value;
+    for (int b = 0; b < 4; b++) {
+        hash ^= (bits >> (8 * b)) & 0xff;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static inline uint64_t snapshot_topology_hash(const Topology* topology) {
+    uint64_t hash = snapshot_hash_int(14695981039346656037ull, topology->node_cnt);
+    for (int i = 0; i < topology->link_cnt; i++) {
+        hash = snapshot_hash_int(hash, topology->links[i].src);
+        hash = snapshot_hash_int(hash, topology->links[i].dst);
+        hash = snapshot_hash_int(hash, topology->links[i].cost);
+    }
+    return hash;
+}
+
+// 변경 사항 하나를 키에 이어서 해시
+static inline uint64_t snapshot_hash_change(uint64_t key, int source, int destination, int distance) {
+    key = snapshot_hash_int(key, source);
+    key = snapshot_hash_int(key, destination);
+    return snapshot_hash_int(key, distance);
+}
+
+static inline uint64_t snapshot_align(uint64_t offset) {
+    return (offset + SNAPSHOT_ALIGN - 1) / SNAPSHOT_ALIGN * SNAPSHOT_ALIGN;
+}
+
+// 구간 사이를 0으로 채움
+static inline int snapshot_pad(FILE* file, uint64_t* offset) {
+    static const char zeros[SNAPSHOT_ALIGN] = {0};
+    uint64_t aligned = snapshot_align(*offset);
+    size_t len = (size_t)(aligned - *offset);
+    *offset = aligned;
+    return len == 0 || fwrite(zeros, 1, len, file) == len;
+}
+
+// 스냅샷 쓰기 (aux는 없으면 NULL). 실패하면 오류를 알리고 -1
+// 다른 파일 이름에 쓴 뒤 rename하므로 같은 파일을 읽고 있는 프로세스에는 영향이 없음
+static inline int snapshot_save(const char* path, const char* program, const char* engine, const Topology* topology,
+                                const Link* changes, int change_cnt, const RouteTable* table, const int* aux) {
+    size_t cells = (size_t)table->node_cnt * table->node_cnt;
+    size_t word = table->compact ? sizeof(uint16_t) : sizeof(uint32_t);
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.header_size = sizeof(header);
+    strncpy(header.program, program, sizeof(header.program) - 1);
+    strncpy(header.engine, engine, sizeof(header.engine) - 1);
+    header.topology_hash = snapshot_topology_hash(topology);
+    header.key = header.topology_hash;
+    for (int k = 0; k < change_cnt; k++) {
+        header.key = snapshot_hash_change(header.key, changes[k].src, changes[k].dst, changes[k].cost);
+    }
+    header.node_cnt = table->node_cnt;
+    header.compact = table->compact;
+    header.max_weight = table->max_weight;
+    header.change_cnt = change_cnt;
+    header.changes_offset = snapshot_align(sizeof(header));
+    header.table_offset = snapshot_align(header.changes_offset + sizeof(int32_t) * 3 * (uint64_t)change_cnt);
+    header.table_bytes = word * 2 * cells;
+    uint64_t end = header.table_offset + header.table_bytes;
+    if (aux) {
+        header.aux_offset = snapshot_align(end);
+        end = header.aux_offset + sizeof(int32_t) * (uint64_t)cells;
+    }
+    header.file_size = end;
+
+    size_t path_len = strlen(path);
+    char* temp = (char*)malloc(path_len + 5);
+    memcpy(temp, path, path_len);
+    memcpy(temp + path_len, ".tmp", 5);
+    FILE* file = fopen(temp, "wb");
+    int ok = file != NULL;
+    uint64_t offset = sizeof(header);
+    if (ok) {
+        ok = fwrite(&header, sizeof(header), 1, file) == 1 && snapshot_pad(file, &offset);
+    }
+    for (int k = 0; ok && k < change_cnt; k++) {
+        int32_t triple[3] = {changes[k].src, changes[k].dst, changes[k].cost};
+        ok = fwrite(triple, sizeof(triple), 1, file) == 1;
+        offset += sizeof(triple);
+    }
+    if (ok) {
+        ok = snapshot_pad(file, &offset) && fwrite(table->dist, 1, header.table_bytes, file) == header.table_bytes;
+        offset += header.table_bytes;
+    }
+    if (ok && aux) {
+        ok = snapshot_pad(file, &offset) && fwrite(aux, sizeof(int32_t), cells, file) == cells;
+    }
+    if (file && fclose(file) != 0) {
+        ok = 0;
+    }
+    if (ok) {
+        ok = rename(temp, path) == 0;
+    }
+    if (!ok) {
+        printf("Error: cannot write snapshot %s\n", path);
+        unlink(temp);
+    }
+    free(temp);
+    return ok ? 0 : -1;
+}
+
+static inline void snapshot_close(RouteSnapshot* snapshot) {
+    if (snapshot->base) {
+        munmap(snapshot->base, snapshot->size);
+    }
+    snapshot->base = NULL;
+}
+
+// 스냅샷을 mmap하고 지금 입력(프로그램, 엔진, 토폴로지)에 맞는지 확인. 맞으면 0
+// 파일이 없거나 맞지 않으면 이유를 알리고 -1 (호출한 쪽은 처음부터 계산)
+static inline int snapshot_open(RouteSnapshot* snapshot, const char* path, const char* program, const char* engine, const Topology* topology) {
+    memset(snapshot, 0, sizeof(*snapshot));
+    int fd = open(path, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SnapshotHeader)) {
+        printf("Snapshot %s not loaded: %s\n", path, fd < 0 ? "cannot read file" : "truncated or corrupt file");
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    void* base = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        printf("Snapshot %s not loaded: cannot map file\n", path);
+        return -1;
+    }
+    snapshot->base = base;
+    snapshot->size = (size_t)info.st_size;
+    const SnapshotHeader* header = snapshot->header = (const SnapshotHeader*)base;
+
+    const char* reason = NULL;
+    size_t cells = header->node_cnt > 0 ? (size_t)header->node_cnt * header->node_cnt : 0;
+    size_t word = header->compact ? sizeof(uint16_t) : sizeof(uint32_t);
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0) {
+        reason = "not a snapshot file";
+    } else if (header->version != SNAPSHOT_VERSION || header->header_size != sizeof(SnapshotHeader)) {
+        reason = "unsupported snapshot version";
+    } else if (header->file_size != snapshot->size || header->change_cnt < 0 || header->node_cnt < 0 ||
+               header->changes_offset + sizeof(int32_t) * 3 * (uint64_t)header->change_cnt > header->table_offset ||
+               header->table_bytes != word * 2 * cells || header->table_offset + header->table_bytes > snapshot->size ||
+               (header->aux_offset && header->aux_offset + sizeof(int32_t) * (uint64_t)cells > snapshot->size)) {
+        reason = "truncated or corrupt file";
+    } else if (strncmp(header->program, program, sizeof(header->program)) != 0 || strncmp(header->engine, engine, sizeof(header->engine)) != 0) {
+        reason = "written by a different engine";
+    } else if (header->node_cnt != topology->node_cnt || header->topology_hash != snapshot_topology_hash(topology)) {
+        reason = "topology changed";
+    }
+    if (!reason) {
+        snapshot->changes = (const int32_t*)((const char*)base + header->changes_offset);
+        uint64_t key = header->topology_hash;
+        for (int k = 0; k < header->change_cnt; k++) {
+            const int32_t* change = snapshot->changes + 3 * k;
+            key = snapshot_hash_change(key, change[0], change[1], change[2]);
+            if (change[0] < 0 || change[0] >= header->node_cnt || change[1] < 0 || change[1] >= header->node_cnt) {
+                reason = "truncated or corrupt file";
+            }
+        }
+        if (!reason && key != header->key) {
+            reason = "truncated or corrupt file";
+        }
+    }
+    if (reason) {
+        printf("Snapshot %s not loaded: %s\n", path, reason);
+        snapshot_close(snapshot);
+        return -1;
+    }
+
+    snapshot->table.node_cnt = header->node_cnt;
+    snapshot->table.compact = header->compact;
+    snapshot->table.max_weight = header->max_weight;
+    snapshot->table.dist = (char*)base + header->table_offset;
+    snapshot->table.next = (char*)snapshot->table.dist + word * cells;
+    snapshot->table.capacity = header->table_bytes;
+    snapshot->table.borrowed = 1;
+    snapshot->aux = header->aux_offset ? (const int32_t*)((const char*)base + header->aux_offset) : NULL;
+    return 0;
+}
+
+// 변경 사항 k번째 (0부터)
+static inline void snapshot_change(const RouteSnapshot* snapshot, int k, int* source, int* destination, int* distance) {
+    *source = snapshot->changes[3 * k];
+    *destination = snapshot->changes[3 * k + 1];
+    *distance = snapshot->changes[3 * k + 2];
+}
+
+#endif
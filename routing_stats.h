@@ -0,0 +1,237 @@
+#ifndef ROUTING_STATS_H
+#define ROUTING_STATS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "routing_table.h"
+#include "routing_timer.h"
+
+// 실행 통계 카운터 (-c 파일) - 변경 사항마다 계산 시간, 바뀐 경로 수, 기록한 바이트 수와
+// 알고리즘 카운터(sweep 수, relaxation 수, 힙 연산 수, 최소값 탐색 수)를 모아 끝날 때 파일로 씀
+// 파일 이름이 .prom으로 끝나면 Prometheus 텍스트 형식, 아니면 JSON
+// 컴파일할 때 -DROUTING_STATS=0이면 카운터 코드가 모두 빠짐 (-c는 받지만 기록하지 않음)
+// 핫 루프는 지역 변수에 세고 함수가 끝날 때 STAT_ADD로 한 번 더함 (스레드 간에는 relaxed atomic)
+#ifndef ROUTING_STATS
+#define ROUTING_STATS 1
+#endif
+
+enum StatCounter {
+    STAT_SWEEPS,        // DV: 전체 라우터를 한 번씩 갱신한 횟수 (sweep, sync 라운드)
+    STAT_UPDATES,       // DV worklist: 이웃에게 바뀐 경로를 알린 라우터 수
+    STAT_RELAXATIONS,   // 거리가 줄어든 횟수 (sweep, sync는 라운드에서 바뀐 칸 수)
+    STAT_HEAP_PUSHES,   // LS: 힙 삽입 / decrease-key
+    STAT_HEAP_POPS,
+    STAT_MIN_SCANS,     // LS dense: smallest_index 호출 수 (노드 수만큼 선형 탐색)
+    STAT_COUNT
+};
+
+static const char* const stat_names[STAT_COUNT] = {
+    "sweeps", "updates", "relaxations", "heap_pushes", "heap_pops", "min_scans"
+};
+
+// 변경 사항 하나 (0번은 처음 수렴)
+typedef struct StatEvent_ {
+    double seconds;             // 변경 적용부터 수렴까지 (change_network + 계산)
+    long long routes_changed;   // 지난번과 거리나 다음 홉이 달라진 칸 수 (-1이면 세지 않음)
+    uint64_t bytes;             // 이 변경 사항의 출력 바이트 수
+    uint64_t counters[STAT_COUNT];
+} StatEvent;
+
+typedef struct RoutingStats_ {
+    int enabled;
+    const char* path;           // 결과 파일
+    const char* program;
+    const char* engine;
+    int nodes;
+    uint64_t counters[STAT_COUNT];
+    uint64_t mark_counters[STAT_COUNT]; // 이번 변경 사항이 시작할 때의 카운터
+    double mark;                // 이번 변경 사항이 시작한 시각
+    uint64_t mark_bytes;        // 이번 변경 사항 전까지 출력한 바이트 수
+    StatEvent* events;
+    int event_cnt;
+    int event_cap;
+    int node_cnt;               // 바뀐 경로 수를 세기 위한 지난번 테이블
+    uint32_t* last_dist;
+    uint32_t* last_next;
+} RoutingStats;
+
+static RoutingStats routing_stats;
+
+#if ROUTING_STATS
+#define STAT_ADD(counter, n) \
+    do { \
+        if (routing_stats.enabled) { \
+            __atomic_fetch_add(&routing_stats.counters[counter], (uint64_t)(n), __ATOMIC_RELAXED); \
+        } \
+    } while (0)
+#else
+#define STAT_ADD(counter, n) do { } while (0)
+#endif
+
+static inline void stats_enable(const char* path, const char* program, const char* engine) {
+    routing_stats.enabled = ROUTING_STATS;
+    routing_stats.path = path;
+    routing_stats.program = program;
+    routing_stats.engine = engine;
+}
+
+// 첫 변경 사항(처음 수렴)의 시작
+static inline void stats_start(int nodes) {
+    if (!routing_stats.enabled) {
+        return;
+    }
+    routing_stats.nodes = nodes;
+    routing_stats.mark = timer_now();
+    memcpy(routing_stats.mark_counters, routing_stats.counters, sizeof(routing_stats.counters));
+}
+
+// 지난번 테이블과 달라진 칸 수
+static inline long long stats_routes_changed(const RouteView* view) {
+    int node_cnt = view->node_cnt;
+    size_t cells = (size_t)node_cnt * node_cnt;
+    if (routing_stats.node_cnt != node_cnt || !routing_stats.last_dist) {
+        free(routing_stats.last_dist);
+        free(routing_stats.last_next);
+        routing_stats.node_cnt = node_cnt;
+        routing_stats.last_dist = (uint32_t*)malloc(sizeof(uint32_t) * (cells > 0 ? cells : 1));
+        routing_stats.last_next = (uint32_t*)malloc(sizeof(uint32_t) * (cells > 0 ? cells : 1));
+        for (size_t c = 0; c < cells; c++) {
+            routing_stats.last_dist[c] = ROUTE_NONE;
+            routing_stats.last_next[c] = ROUTE_NONE;
+        }
+    }
+    long long changed = 0;
+    for (int i = 0; i < node_cnt; i++) {
+        size_t row = (size_t)i * node_cnt;
+        for (int j = 0; j < node_cnt; j++) {
+            uint32_t distance = view->dist(view->ctx, i, j);
+            uint32_t next = distance == ROUTE_NONE ? ROUTE_NONE : view->next(view->ctx, i, j);
+            if (distance != routing_stats.last_dist[row + j] || next != routing_stats.last_next[row + j]) {
+                routing_stats.last_dist[row + j] = distance;
+                routing_stats.last_next[row + j] = next;
+                changed++;
+            }
+        }
+    }
+    return changed;
+}
+
+// 변경 사항 하나의 계산이 끝남 - 시간과 카운터를 기록 (view가 NULL이면 바뀐 경로 수는 세지 않음)
+static inline void stats_event(const RouteView* view) {
+    if (!routing_stats.enabled) {
+        return;
+    }
+    if (routing_stats.event_cnt == routing_stats.event_cap) {
+        routing_stats.event_cap = routing_stats.event_cap ? routing_stats.event_cap * 2 : 64;
+        routing_stats.events = (StatEvent*)realloc(routing_stats.events, sizeof(StatEvent) * routing_stats.event_cap);
+    }
+    StatEvent* event = &routing_stats.events[routing_stats.event_cnt++];
+    event->seconds = timer_now() - routing_stats.mark;
+    for (int c = 0; c < STAT_COUNT; c++) {
+        event->counters[c] = routing_stats.counters[c] - routing_stats.mark_counters[c];
+    }
+    event->bytes = 0;
+    event->routes_changed = view ? stats_routes_changed(view) : -1;
+}
+
+// 변경 사항 하나의 출력이 끝남 (total: 지금까지 출력한 바이트 수) - 다음 변경 사항을 시작
+static inline void stats_event_output(uint64_t total) {
+    if (!routing_stats.enabled) {
+        return;
+    }
+    if (routing_stats.event_cnt > 0) {
+        routing_stats.events[routing_stats.event_cnt - 1].bytes = total - routing_stats.mark_bytes;
+    }
+    routing_stats.mark_bytes = total;
+    stats_start(routing_stats.nodes);
+}
+
+static inline void stats_write_json(FILE* file) {
+    const RoutingStats* stats = &routing_stats;
+    fprintf(file, "{\n  \"program\": \"%s\",\n  \"engine\": \"%s\",\n  \"nodes\": %d,\n  \"events\": %d,\n",
+            stats->program, stats->engine, stats->nodes, stats->event_cnt);
+    fprintf(file, "  \"totals\": {\"bytes_written\": %llu", (unsigned long long)stats->mark_bytes);
+    for (int c = 0; c < STAT_COUNT; c++) {
+        fprintf(file, ", \"%s\": %llu", stat_names[c], (unsigned long long)stats->counters[c]);
+    }
+    fprintf(file, "},\n  \"per_event\": [");
+    for (int e = 0; e < stats->event_cnt; e++) {
+        const StatEvent* event = &stats->events[e];
+        fprintf(file, "%s\n    {\"event\": %d, \"seconds\": %.9f, \"routes_changed\": %lld, \"bytes\": %llu",
+                e > 0 ? "," : "", e, event->seconds, event->routes_changed, (unsigned long long)event->bytes);
+        for (int c = 0; c < STAT_COUNT; c++) {
+            fprintf(file, ", \"%s\": %llu", stat_names[c], (unsigned long long)event->counters[c]);
+        }
+        fprintf(file, "}");
+    }
+    fprintf(file, "\n  ]\n}\n");
+}
+
+// Prometheus 텍스트 형식 - 전체 합계는 counter, 변경 사항별 값은 event 레이블을 단 gauge
+static inline void stats_write_prometheus(FILE* file) {
+    const RoutingStats* stats = &routing_stats;
+    char labels[128];
+    snprintf(labels, sizeof(labels), "program=\"%s\",engine=\"%s\"", stats->program, stats->engine);
+
+    fprintf(file, "# HELP routing_events_total Change events processed (event 0 is the initial convergence).\n");
+    fprintf(file, "# TYPE routing_events_total counter\nrouting_events_total{%s} %d\n", labels, stats->event_cnt);
+    fprintf(file, "# HELP routing_bytes_written_total Bytes written to the output file.\n");
+    fprintf(file, "# TYPE routing_bytes_written_total counter\nrouting_bytes_written_total{%s} %llu\n",
+            labels, (unsigned long long)stats->mark_bytes);
+    for (int c = 0; c < STAT_COUNT; c++) {
+        fprintf(file, "# TYPE routing_%s_total counter\nrouting_%s_total{%s} %llu\n",
+                stat_names[c], stat_names[c], labels, (unsigned long long)stats->counters[c]);
+    }
+
+    fprintf(file, "# HELP routing_event_seconds Time to apply a change and reconverge.\n");
+    fprintf(file, "# TYPE routing_event_seconds gauge\n");
+    for (int e = 0; e < stats->event_cnt; e++) {
+        fprintf(file, "routing_event_seconds{%s,event=\"%d\"} %.9f\n", labels, e, stats->events[e].seconds);
+    }
+    fprintf(file, "# HELP routing_event_routes_changed Routing table cells whose distance or next hop changed.\n");
+    fprintf(file, "# TYPE routing_event_routes_changed gauge\n");
+    for (int e = 0; e < stats->event_cnt; e++) {
+        if (stats->events[e].routes_changed >= 0) {
+            fprintf(file, "routing_event_routes_changed{%s,event=\"%d\"} %lld\n", labels, e, stats->events[e].routes_changed);
+        }
+    }
+    fprintf(file, "# TYPE routing_event_bytes gauge\n");
+    for (int e = 0; e < stats->event_cnt; e++) {
+        fprintf(file, "routing_event_bytes{%s,event=\"%d\"} %llu\n", labels, e, (unsigned long long)stats->events[e].bytes);
+    }
+    for (int c = 0; c < STAT_COUNT; c++) {
+        fprintf(file, "# TYPE routing_event_%s gauge\n", stat_names[c]);
+        for (int e = 0; e < stats->event_cnt; e++) {
+            fprintf(file, "routing_event_%s{%s,event=\"%d\"} %llu\n",
+                    stat_names[c], labels, e, (unsigned long long)stats->events[e].counters[c]);
+        }
+    }
+}
+
+// 결과 파일 기록 후 정리
+static inline void stats_report() {
+    if (!routing_stats.enabled) {
+        return;
+    }
+    FILE* file = fopen(routing_stats.path, "w");
+    if (!file) {
+        printf("Error: cannot write %s\n", routing_stats.path);
+    } else {
+        size_t len = strlen(routing_stats.path);
+        if (len >= 5 && strcmp(routing_stats.path + len - 5, ".prom") == 0) {
+            stats_write_prometheus(file);
+        } else {
+            stats_write_json(file);
+        }
+        fclose(file);
+    }
+    free(routing_stats.events);
+    free(routing_stats.last_dist);
+    free(routing_stats.last_next);
+    routing_stats.events = NULL;
+    routing_stats.last_dist = routing_stats.last_next = NULL;
+}
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef ROUTING_STREAM_H
+#define ROUTING_STREAM_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include "routing_input.h"
+
+// 변경 사항 스트림 - 미리 읽어 둔 변경 사항 배열이 있으면 차례로 넘겨주고,
+// 없으면(stdin, follow 모드) 변경 파일을 처음부터 한 줄씩 한 번만 읽음
+// follow 모드에서는 파일 끝에 도달해도 끝내지 않고 새 줄이 추가되기를 기다림 (tail -f)
+typedef struct ChangeStream_ {
+    FILE* file;
+    const ChangeList* list;
+    int index;          // list에서 다음에 넘겨줄 변경 사항
+    int node_cnt;       // 노드 번호 확인용
+    int line_no;        // 읽은 줄 수
+    int follow;
+    long long time;     // 마지막으로 넘겨준 변경 사항의 시각 (네 번째 열)
+    char* line;         // 아직 개행이 오지 않은 줄을 모아두는 버퍼
+    size_t len;
+    size_t cap;
+} ChangeStream;
+
+static volatile sig_atomic_t change_stream_stopped = 0;
+
+static inline void change_stream_on_signal(int signo) {
+    (void)signo;
+    change_stream_stopped = 1;
+}
+
+// "-"이면 stdin, 아니면 파일 열기
+static inline FILE* open_changes_file(const char* path) {
+    if (strcmp(path, "-") == 0) {
+        return stdin;
+    }
+    return fopen(path, "r");
+}
+
+static inline void change_stream_init(ChangeStream* stream, FILE* file, const ChangeList* list, int node_cnt, int follow) {
+    stream->file = file;
+    stream->list = list;
+    stream->index = 0;
+    stream->node_cnt = node_cnt;
+    stream->line_no = 0;
+    stream->follow = follow;
+    stream->time = 0;
+    stream->cap = 128;
+    stream->len = 0;
+    stream->line = (char*)malloc(stream->cap);
+    if (follow) {
+        // 따라 읽기는 SIGINT/SIGTERM으로 끝냄
+        signal(SIGINT, change_stream_on_signal);
+        signal(SIGTERM, change_stream_on_signal);
+    }
+}
+
+static inline void change_stream_free(ChangeStream* stream) {
+    free(stream->line);
+    stream->line = NULL;
+}
+
+// 다음 변경 사항을 읽음 (같은 줄에 네 번째 정수가 있으면 stream->time에 시각으로 기록). 읽었으면 1, 스트림이 끝났거나 형식이 잘못된 줄이면 0
+// (change_network처럼 세 정수로 읽히지 않는 줄이나 노드 번호가 범위를 벗어난 줄에서 처리를 멈춤)
+static inline int change_stream_next(ChangeStream* stream, int* source, int* destination, int* distance) {
+    if (stream->list) {
+        if (stream->index >= stream->list->change_cnt) {
+            return 0;
+        }
+        const Link* change = &stream->list->changes[stream->index++];
+        *source = change->src;
+        *destination = change->dst;
+        *distance = change->cost;
+        stream->time = change->time;
+        return 1;
+    }
+
+    for (;;) {
+        int c = getc(stream->file);
+        if (c == EOF) {
+            if (stream->follow && !change_stream_stopped) {
+                clearerr(stream->file);
+                usleep(100000);
+                continue;
+            }
+            if (stream->len == 0) {
+                return 0;
+            }
+            c = '\n'; // 개행 없이 끝난 마지막 줄
+        }
+        if (c != '\n') {
+            if (stream->len + 1 >= stream->cap) {
+                stream->cap *= 2;
+                stream->line = (char*)realloc(stream->line, stream->cap);
+            }
+            stream->line[stream->len++] = (char)c;
+            continue;
+        }
+
+        stream->line[stream->len] = '\0';
+        stream->line_no++;
+        Scanner scanner;
+        Link change;
+        scanner.pos = stream->line;
+        scanner.end = stream->line + stream->len;
+        scanner.line = stream->line_no;
+        stream->len = 0;
+        scan_space(&scanner);
+        if (scanner.pos == scanner.end) {
+            continue; // 빈 줄은 건너뜀
+        }
+        if (!scan_link(&scanner, &change) || !input_check_node("changes", stream->line_no, change.src, stream->node_cnt) || !input_check_node("changes", stream->line_no, change.dst, stream->node_cnt)) {
+            return 0;
+        }
+        scan_time(&scanner, &stream->time); // 시각이 없는 줄은 앞 줄의 시각을 그대로 씀
+        *source = change.src;
+        *destination = change.dst;
+        *distance = change.cost;
+        return 1;
+    }
+}
+
+#endif
@@ -0,0 +1,229 @@
+#ifndef ROUTING_TABLE_H
+#define ROUTING_TABLE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "routing_graph.h"
+
+#define ROUTE_NONE UINT32_MAX   // route_get_* / route_set에서 도달 불가 거리, 다음 홉 없음
+
+// 라우팅 테이블 - 모든 라우터의 거리 배열과 다음 홉 배열을 한 번에 할당한 블록에 연속으로 둠
+// dist[i * node_cnt + j]: i에서 j까지의 거리, next[i * node_cnt + j]: i에서 j로 갈 때 다음 홉
+// 기본은 uint32_t, 노드 수와 링크 비용이 작아 모든 최단 거리가 들어가면 uint16_t(compact)
+// 도달 불가 거리와 다음 홉 없음은 자료형의 최댓값 (route_infinity<T>())
+typedef struct RouteTable_ {
+    int node_cnt;
+    int compact;        // 1이면 uint16_t 배열
+    int max_weight;     // 지금까지 반영한 가장 큰 링크 비용
+    void* dist;         // 블록의 시작 (해제할 때 사용)
+    void* next;         // 블록 안의 다음 홉 배열 위치
+    size_t capacity;    // 블록 크기 (바이트) - uint32_t 테이블이 들어가면 넓힐 때 그 자리에서 바꿈
+    int borrowed;       // 블록을 빌려 씀 (arena, mmap) - route_table_free가 해제하지 않음
+} RouteTable;
+
+template <typename T>
+static inline T* route_dist(RouteTable* table) {
+    return (T*)table->dist;
+}
+
+template <typename T>
+static inline T* route_next(RouteTable* table) {
+    return (T*)table->next;
+}
+
+// 최단 경로는 최대 node_cnt - 1개의 링크를 지나므로 (node_cnt - 1) * max_weight가 들어가면 uint16_t 사용 가능
+static inline int route_table_fits_compact(int node_cnt, int max_weight) {
+    return node_cnt < UINT16_MAX && (long long)(node_cnt > 0 ? node_cnt - 1 : 0) * max_weight < UINT16_MAX;
+}
+
+// 테이블 할당 (내용은 채우지 않음)
+static inline void route_table_init(RouteTable* table, int node_cnt, int max_weight) {
+    size_t cells = (size_t)node_cnt * node_cnt;
+    table->node_cnt = node_cnt;
+    table->max_weight = max_weight;
+    table->compact = route_table_fits_compact(node_cnt, max_weight);
+    size_t word = table->compact ? sizeof(uint16_t) : sizeof(uint32_t);
+    table->capacity = word * 2 * (cells > 0 ? cells : 1);
+    table->borrowed = 0;
+    table->dist = malloc(table->capacity);
+    table->next = (char*)table->dist + word * cells;
+}
+
+static inline void route_table_free(RouteTable* table) {
+    if (!table->borrowed) {
+        free(table->dist);
+    }
+    table->dist = table->next = NULL;
+}
+
+// uint32_t 테이블 하나가 차지하는 크기 (빌려 줄 블록의 크기)
+static inline size_t route_table_bytes(int node_cnt) {
+    size_t cells = (size_t)node_cnt * node_cnt;
+    return sizeof(uint32_t) * 2 * (cells > 0 ? cells : 1);
+}
+
+// 링크 비용을 하나도 반영하지 않은 처음 자료형으로 되돌림 (블록은 그대로, 내용은 채우지 않음)
+static inline void route_table_rewind(RouteTable* table) {
+    size_t cells = (size_t)table->node_cnt * table->node_cnt;
+    table->max_weight = 0;
+    table->compact = route_table_fits_compact(table->node_cnt, 0);
+    table->next = (char*)table->dist + (table->compact ? sizeof(uint16_t) : sizeof(uint32_t)) * cells;
+}
+
+// 호출한 쪽이 잡아 둔 블록(route_table_bytes 크기)에 테이블을 둠 - 이후 넓히거나 복사해도 다시 할당하지 않음
+static inline void route_table_borrow(RouteTable* table, void* block, int node_cnt) {
+    table->node_cnt = node_cnt;
+    table->dist = block;
+    table->capacity = route_table_bytes(node_cnt);
+    table->borrowed = 1;
+    route_table_rewind(table);
+}
+
+// uint16_t 테이블을 같은 내용의 uint32_t 테이블로 바꿈
+// 블록에 uint32_t 테이블이 들어가면 그 자리에서 뒤쪽 칸부터 옮김 (옮길 자리가 항상 아직 읽지 않은 칸보다 뒤)
+static inline void route_table_widen(RouteTable* table) {
+    if (!table->compact) {
+        return;
+    }
+    size_t cells = (size_t)table->node_cnt * table->node_cnt;
+    const uint16_t* dist = route_dist<uint16_t>(table);
+    const uint16_t* next = route_next<uint16_t>(table);
+    if (table->capacity >= route_table_bytes(table->node_cnt)) {
+        uint32_t* block = (uint32_t*)table->dist;
+        for (size_t c = cells; c-- > 0; ) {
+            block[cells + c] = next[c] == UINT16_MAX ? UINT32_MAX : next[c];
+        }
+        for (size_t c = cells; c-- > 0; ) {
+            block[c] = dist[c] == UINT16_MAX ? UINT32_MAX : dist[c];
+        }
+        table->next = block + cells;
+        table->compact = 0;
+        return;
+    }
+    uint32_t* block = (uint32_t*)malloc(route_table_bytes(table->node_cnt));
+    for (size_t c = 0; c < cells; c++) {
+        block[c] = dist[c] == UINT16_MAX ? UINT32_MAX : dist[c];
+        block[cells + c] = next[c] == UINT16_MAX ? UINT32_MAX : next[c];
+    }
+    route_table_free(table);
+    table->capacity = route_table_bytes(table->node_cnt);
+    table->borrowed = 0;
+    table->dist = block;
+    table->next = block + cells;
+    table->compact = 0;
+}
+
+// 링크 비용 weight가 생길 수 있음을 알림 - uint16_t로 최단 거리를 담을 수 없게 되면 넓힘
+static inline void route_table_reserve(RouteTable* table, int weight) {
+    if (weight <= table->max_weight) {
+        return;
+    }
+    table->max_weight = weight;
+    if (table->compact && !route_table_fits_compact(table->node_cnt, weight)) {
+        route_table_widen(table);
+    }
+}
+
+// src와 같은 내용으로 dst를 채움 (dst의 블록에 들어가지 않으면 다시 할당)
+static inline void route_table_copy(RouteTable* dst, const RouteTable* src) {
+    size_t cells = (size_t)src->node_cnt * src->node_cnt;
+    size_t word = src->compact ? sizeof(uint16_t) : sizeof(uint32_t);
+    size_t bytes = word * 2 * (cells > 0 ? cells : 1);
+    if (dst->capacity < bytes) {
+        route_table_free(dst);
+        dst->capacity = bytes;
+        dst->borrowed = 0;
+        dst->dist = malloc(bytes);
+    }
+    if (dst->node_cnt != src->node_cnt || dst->compact != src->compact) {
+        dst->node_cnt = src->node_cnt;
+        dst->compact = src->compact;
+        dst->next = (char*)dst->dist + word * cells;
+    }
+    dst->max_weight = src->max_weight;
+    memcpy(dst->dist, src->dist, word * 2 * cells);
+}
+
+// 한 칸 읽기/쓰기 (자료형과 상관없이 도달 불가/다음 홉 없음은 ROUTE_NONE)
+static inline uint32_t route_get_dist(const RouteTable* table, int i, int j) {
+    size_t cell = (size_t)i * table->node_cnt + j;
+    if (table->compact) {
+        uint16_t value = ((const uint16_t*)table->dist)[cell];
+        return value == UINT16_MAX ? ROUTE_NONE : value;
+    }
+    return ((const uint32_t*)table->dist)[cell];
+}
+
+static inline uint32_t route_get_next(const RouteTable* table, int i, int j) {
+    size_t cell = (size_t)i * table->node_cnt + j;
+    if (table->compact) {
+        uint16_t value = ((const uint16_t*)table->next)[cell];
+        return value == UINT16_MAX ? ROUTE_NONE : value;
+    }
+    return ((const uint32_t*)table->next)[cell];
+}
+
+static inline void route_set(RouteTable* table, int i, int j, uint32_t distance, uint32_t next) {
+    size_t cell = (size_t)i * table->node_cnt + j;
+    if (table->compact) {
+        ((uint16_t*)table->dist)[cell] = distance == ROUTE_NONE ? UINT16_MAX : (uint16_t)distance;
+        ((uint16_t*)table->next)[cell] = next == ROUTE_NONE ? UINT16_MAX : (uint16_t)next;
+    } else {
+        ((uint32_t*)table->dist)[cell] = distance;
+        ((uint32_t*)table->next)[cell] = next;
+    }
+}
+
+// 자기 자신만 아는 상태로 초기화 (거리 0, 다음 홉은 자기 자신, 나머지는 도달 불가)
+static inline void route_table_reset(RouteTable* table) {
+    for (int i = 0; i < table->node_cnt; i++) {
+        for (int j = 0; j < table->node_cnt; j++) {
+            if (i == j) {
+                route_set(table, i, j, 0, (uint32_t)i);
+            } else {
+                route_set(table, i, j, ROUTE_NONE, ROUTE_NONE);
+            }
+        }
+    }
+}
+
+// 엔진의 한 행(거리, 다음 홉 - 도달 불가는 next < 0)을 테이블의 start 행에 기록
+static inline void route_store_row(RouteTable* table, int start, const int* dist, const int* next) {
+    for (int j = 0; j < table->node_cnt; j++) {
+        if (next[j] < 0 || dist[j] >= ROUTE_INFINITY) {
+            route_set(table, start, j, ROUTE_NONE, ROUTE_NONE);
+        } else {
+            route_set(table, start, j, (uint32_t)dist[j], (uint32_t)next[j]);
+        }
+    }
+}
+
+// 엔진이 라우팅 정보를 보여주는 방법 (라우팅 테이블, lazy 캐시 등)
+// 도달 불가 거리와 다음 홉 없음은 ROUTE_NONE
+typedef struct RouteView_ {
+    int node_cnt;
+    uint32_t (*dist)(void* ctx, int from, int to);
+    uint32_t (*next)(void* ctx, int from, int to);
+    void* ctx;
+} RouteView;
+
+static inline uint32_t route_view_table_dist(void* ctx, int from, int to) {
+    return route_get_dist((const RouteTable*)ctx, from, to);
+}
+
+static inline uint32_t route_view_table_next(void* ctx, int from, int to) {
+    return route_get_next((const RouteTable*)ctx, from, to);
+}
+
+// 라우팅 테이블을 보여주는 RouteView
+static inline RouteView route_view_table(const RouteTable* table) {
+    RouteView view;
+    view.node_cnt = table->node_cnt;
+    view.dist = route_view_table_dist;
+    view.next = route_view_table_next;
+    view.ctx = (void*)table;
+    return view;
+}
+
+#endif
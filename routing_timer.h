@@ -0,0 +1,74 @@
+#ifndef ROUTING_TIMER_H
+#define ROUTING_TIMER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// 단계별 시간 측정 (-t) - 입력 읽기, 변경 사항마다의 계산(0번은 처음 수렴/SPF), 메시지 경로 출력, 테이블 출력
+// 마지막 기록 시점(mark)부터 지금까지의 시간을 해당 단계에 더하는 방식이라 각 단계가 끝날 때 한 번씩 부름
+// 끝나면 stderr에 "timing <단계> ..." 줄로 알림 (bench/routing_bench가 읽음)
+typedef struct PhaseTimer_ {
+    int enabled;
+    double mark;        // 마지막으로 기록한 시각
+    double parse;
+    double trace;       // 메시지 경로 출력
+    double output;      // 라우팅 테이블 출력과 파일 기록
+    double* events;     // 변경 사항별 계산 시간
+    int event_cnt;
+    int event_cap;
+} PhaseTimer;
+
+static PhaseTimer phase_timer;
+
+static inline double timer_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static inline void timer_start() {
+    if (phase_timer.enabled) {
+        phase_timer.mark = timer_now();
+    }
+}
+
+// 마지막 기록 이후의 시간을 phase에 더함
+static inline void timer_add(double* phase) {
+    if (!phase_timer.enabled) {
+        return;
+    }
+    double now = timer_now();
+    *phase += now - phase_timer.mark;
+    phase_timer.mark = now;
+}
+
+// 마지막 기록 이후의 시간을 다음 변경 사항의 계산 시간으로 기록
+static inline void timer_event() {
+    if (!phase_timer.enabled) {
+        return;
+    }
+    if (phase_timer.event_cnt == phase_timer.event_cap) {
+        phase_timer.event_cap = phase_timer.event_cap ? phase_timer.event_cap * 2 : 64;
+        phase_timer.events = (double*)realloc(phase_timer.events, sizeof(double) * phase_timer.event_cap);
+    }
+    double now = timer_now();
+    phase_timer.events[phase_timer.event_cnt++] = now - phase_timer.mark;
+    phase_timer.mark = now;
+}
+
+static inline void timer_report() {
+    if (!phase_timer.enabled) {
+        return;
+    }
+    fprintf(stderr, "timing parse %.9f\n", phase_timer.parse);
+    for (int i = 0; i < phase_timer.event_cnt; i++) {
+        fprintf(stderr, "timing event %d %.9f\n", i, phase_timer.events[i]);
+    }
+    fprintf(stderr, "timing trace %.9f\n", phase_timer.trace);
+    fprintf(stderr, "timing output %.9f\n", phase_timer.output);
+    free(phase_timer.events);
+    phase_timer.events = NULL;
+}
+
+#endif